@@ -22,8 +22,25 @@
 //===----------------------------------------------------------------------===//
 #include "AnalysisPipeline.h"
 
+#include <cstdlib>
+#include <sstream>
+
+#include "AuxDataSchema.h"
 #include "passes/DatalogAnalysisPass.h"
 
+static uint64_t executableSize(const gtirb::Module &Module)
+{
+    uint64_t Size = 0;
+    for(const auto &Section : Module.sections())
+    {
+        if(Section.isFlagSet(gtirb::SectionFlag::Executable))
+        {
+            Size += Section.getSize().value_or(0);
+        }
+    }
+    return Size;
+}
+
 void AnalysisPipeline::configureDebugDir(const std::string &DebugDirRoot, bool MultiModule)
 {
     for(auto &Pass : Passes)
@@ -32,6 +49,12 @@ void AnalysisPipeline::configureDebugDir(const std::string &DebugDirRoot, bool M
     }
 }
 
+void AnalysisPipeline::setThreadCount(unsigned int Count)
+{
+    PipelineExecutor.setThreadCount(Count);
+    setDatalogThreadCount(Count);
+}
+
 void AnalysisPipeline::setDatalogThreadCount(unsigned int Count)
 {
     for(auto &Pass : Passes)
@@ -77,6 +100,128 @@ void AnalysisPipeline::configureSouffleInterpreter(const std::string &Interprete
     }
 }
 
+void AnalysisPipeline::setMaxMemory(uint64_t Bytes)
+{
+    RecordRelations = true;
+    Monitor.setLimit(Bytes, [this](uint64_t ResidentSetSize) {
+        if(!MemoryLimitHit.exchange(true))
+        {
+            notifyMemoryLimit(ResidentSetSize);
+            // Exit before the system kills the process; the main thread is
+            // still running the pass, so skip the static destructors.
+            std::_Exit(EXIT_FAILURE);
+        }
+    });
+}
+
+void AnalysisPipeline::notifyMemoryLimit(uint64_t ResidentSetSize)
+{
+    MemoryLimitReport Report;
+    AnalysisPass *Pass = CurrentPass.load();
+    Report.Pass = Pass ? Pass->getNameSlug() : "";
+    Report.Phase = CurrentPhase.load();
+    Report.ResidentSetSize = ResidentSetSize;
+    Report.Limit = Monitor.getLimit();
+    {
+        std::lock_guard<std::mutex> Lock(RelationsMutex);
+        Report.RelationsPass = RelationsPass;
+        Report.RelationsPhase = RelationsPhase;
+        Report.LargestRelations = LastRelations;
+    }
+
+    for(auto &Listener : Listeners)
+    {
+        Listener->notifyMemoryLimit(Report);
+    }
+}
+
+void AnalysisPipeline::enableRelationSizes()
+{
+    RecordRelations = true;
+}
+
+void AnalysisPipeline::recordRelations(AnalysisPass &Pass, AnalysisPassPhase Phase,
+                                       AnalysisPassResult &Result)
+{
+    DatalogAnalysisPass *DatalogPass = dynamic_cast<DatalogAnalysisPass *>(&Pass);
+    if(!RecordRelations || !DatalogPass)
+    {
+        return;
+    }
+    Result.LargestRelations = DatalogPass->getLargestRelations(RelationCount);
+
+    std::lock_guard<std::mutex> Lock(RelationsMutex);
+    RelationsPass = Pass.getNameSlug();
+    RelationsPhase = Phase;
+    LastRelations = Result.LargestRelations;
+}
+
+void AnalysisPipeline::checkMemory(AnalysisPassResult &Result)
+{
+    Result.PeakMemory = Monitor.resetPeak();
+    uint64_t Limit = Monitor.getLimit();
+    if(Limit == 0 || Result.PeakMemory < MemoryFallbackRatio * Limit)
+    {
+        return;
+    }
+
+    bool Reduced = false;
+    unsigned int Threads = PipelineExecutor.getThreadCount();
+    if(Threads > 1)
+    {
+        setThreadCount(Threads / 2);
+        Reduced = true;
+    }
+    for(auto &Pass : Passes)
+    {
+        Reduced |= reduceCost(*Pass);
+    }
+    if(Reduced)
+    {
+        std::stringstream Warning;
+        Warning << "memory usage reached " << (Result.PeakMemory >> 20) << " MiB of the "
+                << (Limit >> 20) << " MiB limit; continuing with "
+                << PipelineExecutor.getThreadCount() << " threads and cheaper settings";
+        Result.Warnings.push_back(Warning.str());
+    }
+}
+
+void AnalysisPipeline::setDeadline(std::chrono::high_resolution_clock::time_point Time)
+{
+    Deadline = Time;
+}
+
+bool AnalysisPipeline::reduceCost(AnalysisPass &Pass)
+{
+    std::optional<std::string> Step = Pass.reduceCost();
+    if(!Step)
+    {
+        return false;
+    }
+    Reductions.push_back("reduced:" + Pass.getNameSlug() + ":" + *Step);
+    Degradations.push_back(Reductions.back());
+    return true;
+}
+
+bool AnalysisPipeline::checkDeadline(AnalysisPass &Pass, uint64_t CodeSize,
+                                     std::chrono::duration<double> ModuleTime)
+{
+    std::chrono::duration<double> Remaining =
+        *Deadline - std::chrono::high_resolution_clock::now();
+    if(Pass.isOptional())
+    {
+        return Remaining.count() < OptionalPassRatio * ModuleTime.count();
+    }
+
+    double Estimate = CodeSize / CodeRate;
+    while(Estimate > Remaining.count() && reduceCost(Pass))
+    {
+        // Assume that each step of cheaper settings halves the run time.
+        Estimate /= 2;
+    }
+    return false;
+}
+
 std::set<std::string> AnalysisPipeline::getPassSlugs()
 {
     std::set<std::string> Slugs;
@@ -125,17 +270,51 @@ void AnalysisPipeline::notifyPassResult(AnalysisPassPhase Phase, const AnalysisP
         Listener->notifyPassResult(Phase, Result);
     }
 }
+void AnalysisPipeline::notifyPassSkipped(const AnalysisPass &Pass)
+{
+    for(auto &Listener : Listeners)
+    {
+        Listener->notifyPassSkipped(Pass);
+    }
+}
 
 void AnalysisPipeline::run(gtirb::Context &Context, gtirb::Module &Module)
 {
+    Monitor.start();
+    auto StartModule = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> RequiredTime(0);
+    uint64_t CodeSize = executableSize(Module);
+    Degradations = Reductions;
+    bool SkipOptional = false;
+
     AnalysisPass *PreviousPass = nullptr;
     for(auto &Pass : Passes)
     {
+        if(Deadline)
+        {
+            // Once an optional pass is skipped, skip the next ones too: they
+            // may depend on its results (e.g. the SCCs used by NoReturnPass).
+            auto ModuleTime = std::chrono::high_resolution_clock::now() - StartModule;
+            SkipOptional = checkDeadline(*Pass, CodeSize, ModuleTime) || SkipOptional;
+            if(SkipOptional && Pass->isOptional())
+            {
+                Degradations.push_back("skipped:" + Pass->getNameSlug());
+                notifyPassSkipped(*Pass);
+                continue;
+            }
+        }
+        auto StartPass = std::chrono::high_resolution_clock::now();
+
+        CurrentPass = Pass.get();
         notifyPassBegin(*Pass);
         notifyPassPhase(AnalysisPassPhase::LOAD, Pass->hasLoad());
         if(Pass->hasLoad())
         {
+            CurrentPhase = AnalysisPassPhase::LOAD;
+            Monitor.resetPeak();
             auto Result = Pass->load(Context, Module, PreviousPass);
+            checkMemory(Result);
+            recordRelations(*Pass, AnalysisPassPhase::LOAD, Result);
             notifyPassResult(AnalysisPassPhase::LOAD, Result);
         }
 
@@ -151,18 +330,30 @@ void AnalysisPipeline::run(gtirb::Context &Context, gtirb::Module &Module)
         }
 
         notifyPassPhase(AnalysisPassPhase::ANALYZE);
+        CurrentPhase = AnalysisPassPhase::ANALYZE;
+        Monitor.resetPeak();
         auto Result = Pass->analyze(Module);
+        checkMemory(Result);
+        recordRelations(*Pass, AnalysisPassPhase::ANALYZE, Result);
         notifyPassResult(AnalysisPassPhase::ANALYZE, Result);
 
         notifyPassPhase(AnalysisPassPhase::TRANSFORM, Pass->hasTransform());
         if(Pass->hasTransform())
         {
+            CurrentPhase = AnalysisPassPhase::TRANSFORM;
+            Monitor.resetPeak();
             auto Result = Pass->transform(Context, Module);
+            checkMemory(Result);
+            recordRelations(*Pass, AnalysisPassPhase::TRANSFORM, Result);
             notifyPassResult(AnalysisPassPhase::TRANSFORM, Result);
         }
 
         PreviousPass = Pass.get();
         notifyPassEnd(*Pass);
+        if(!Pass->isOptional())
+        {
+            RequiredTime += std::chrono::high_resolution_clock::now() - StartPass;
+        }
     }
 
     // Clear the last pass.
@@ -170,4 +361,18 @@ void AnalysisPipeline::run(gtirb::Context &Context, gtirb::Module &Module)
     {
         PreviousPass->clear();
     }
+    CurrentPass = nullptr;
+    Monitor.stop();
+
+    // Refine the estimate of the run time of the next modules.
+    if(CodeSize > 0 && RequiredTime.count() > 0)
+    {
+        CodeRate = CodeSize / RequiredTime.count();
+    }
+
+    if(!Degradations.empty())
+    {
+        Module.addAuxData<gtirb::schema::DdisasmDegradations>(
+            std::vector<std::string>(Degradations));
+    }
 }
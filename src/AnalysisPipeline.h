@@ -22,7 +22,15 @@
 //===----------------------------------------------------------------------===//
 #ifndef _ANALYSIS_PIPELINE_H_
 #define _ANALYSIS_PIPELINE_H_
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
 #include "Hints.h"
+#include "MemoryMonitor.h"
 #include "passes/AnalysisPass.h"
 
 enum AnalysisPassPhase
@@ -32,6 +40,22 @@ enum AnalysisPassPhase
     TRANSFORM
 };
 
+/**
+Describes the pass running when the memory usage exceeded `--max-memory'.
+*/
+struct MemoryLimitReport
+{
+    std::string Pass;
+    AnalysisPassPhase Phase;
+    uint64_t ResidentSetSize;
+    uint64_t Limit;
+    // Largest relations at the end of the last completed phase of a Datalog
+    // pass, and that pass and phase.
+    std::string RelationsPass;
+    AnalysisPassPhase RelationsPhase;
+    std::vector<std::pair<std::string, size_t>> LargestRelations;
+};
+
 /**
 An AnalysisPipelineListener is notified regarding AnalysisPipeline events.
 
@@ -44,6 +68,22 @@ public:
     virtual void notifyPassEnd(const AnalysisPass& Pass) = 0;
     virtual void notifyPassPhase(AnalysisPassPhase Phase, bool HasPhase = true) = 0;
     virtual void notifyPassResult(AnalysisPassPhase Phase, const AnalysisPassResult& Result) = 0;
+
+    /**
+    Called from the memory monitor thread before the process exits because
+    the memory limit was exceeded.
+    */
+    virtual void notifyMemoryLimit([[maybe_unused]] const MemoryLimitReport& Report)
+    {
+    }
+
+    /**
+    Called instead of notifyPassBegin for an optional pass skipped because
+    the deadline is too close.
+    */
+    virtual void notifyPassSkipped([[maybe_unused]] const AnalysisPass& Pass)
+    {
+    }
 };
 
 class AnalysisPipeline
@@ -58,9 +98,14 @@ public:
     void push(A&&... Args)
     {
         Passes.push_back(std::make_unique<T>(std::forward<A>(Args)...));
+        Passes.back()->setExecutor(&PipelineExecutor);
     }
 
     void configureDebugDir(const std::string& DebugDirRoot, bool MultiModule);
+    /**
+    Set the number of threads shared by the C++ and the Datalog stages.
+    */
+    void setThreadCount(unsigned int Count);
     void setDatalogThreadCount(unsigned int Count);
     void setDatalogProfileDir(const std::string& ProfileDir);
     void enableSouffleOutputs();
@@ -68,6 +113,36 @@ public:
                                      const std::string& LibraryDir);
     void loadHints(const std::string& Path);
 
+    /**
+    Exit with an error naming the running pass when the resident set size
+    exceeds Bytes. Past MemoryFallbackRatio of Bytes, the next passes and
+    modules use fewer threads and cheaper settings.
+    */
+    void setMaxMemory(uint64_t Bytes);
+
+    /**
+    Record the sizes of the largest relations of the Datalog passes at the end
+    of each phase, in AnalysisPassResult::LargestRelations.
+    */
+    void enableRelationSizes();
+    static constexpr size_t RelationCount = 10;
+    static constexpr double MemoryFallbackRatio = 0.75;
+
+    /**
+    Try to finish by Deadline: before each pass, estimate its run time from
+    the size of the code and switch to cheaper settings, or skip it if it is
+    optional, when there is not enough time left. The degradations applied
+    to a module are listed in its `ddisasmDegradations' AuxData table.
+    */
+    void setDeadline(std::chrono::high_resolution_clock::time_point Time);
+
+    // Initial estimate of the bytes of code disassembled per second, refined
+    // with the measured rate of each module.
+    static constexpr double DefaultCodeRate = 32 * 1024;
+    // Estimated run time of the optional passes, relative to the run time of
+    // the other passes of the module.
+    static constexpr double OptionalPassRatio = 0.25;
+
     void run(gtirb::Context& Context, gtirb::Module& Module);
 
 private:
@@ -76,9 +151,46 @@ private:
     void notifyPassEnd(const AnalysisPass& Pass);
     void notifyPassPhase(AnalysisPassPhase Phase, bool HasPhase = true);
     void notifyPassResult(AnalysisPassPhase Phase, const AnalysisPassResult& Result);
+    void notifyMemoryLimit(uint64_t ResidentSetSize);
+    void notifyPassSkipped(const AnalysisPass& Pass);
+
+    // Record the peak memory of a phase and reduce the cost of the next
+    // phases if it is close to the limit.
+    void checkMemory(AnalysisPassResult& Result);
+
+    // Snapshot the relation sizes of Pass once Phase is done, from the thread
+    // that runs the passes.
+    void recordRelations(AnalysisPass& Pass, AnalysisPassPhase Phase,
+                         AnalysisPassResult& Result);
+
+    // Decide whether to skip Pass, or reduce its cost, to meet the deadline.
+    bool checkDeadline(AnalysisPass& Pass, uint64_t CodeSize,
+                       std::chrono::duration<double> ModuleTime);
+
+    // Switch to cheaper settings for the remaining passes and record it.
+    bool reduceCost(AnalysisPass& Pass);
 
     std::list<std::shared_ptr<AnalysisPipelineListener>> Listeners;
     std::list<std::unique_ptr<AnalysisPass>> Passes;
     HintsLoader DatalogHints;
+    Executor PipelineExecutor;
+
+    MemoryMonitor Monitor;
+    std::atomic<AnalysisPass*> CurrentPass{nullptr};
+    std::atomic<AnalysisPassPhase> CurrentPhase{AnalysisPassPhase::LOAD};
+    std::atomic<bool> MemoryLimitHit{false};
+    bool RecordRelations = false;
+    // Last relation sizes recorded, read by the monitor thread.
+    std::mutex RelationsMutex;
+    std::string RelationsPass;
+    AnalysisPassPhase RelationsPhase = AnalysisPassPhase::LOAD;
+    std::vector<std::pair<std::string, size_t>> LastRelations;
+
+    std::optional<std::chrono::high_resolution_clock::time_point> Deadline;
+    double CodeRate = DefaultCodeRate;
+    // Degradations of the settings; these hold for all the next modules.
+    std::vector<std::string> Reductions;
+    // Degradations of the module being analyzed.
+    std::vector<std::string> Degradations;
 };
 #endif /* _ANALYSIS_PIPELINE_H_ */
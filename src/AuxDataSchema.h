@@ -111,6 +111,22 @@ namespace gtirb
             typedef std::string Type;
         };
 
+        /// \brief Auxiliary data recording the analysis bounds (e.g. `step_limit`)
+        /// used to produce the GTIRB.
+        struct AnalysisBudget
+        {
+            static constexpr const char* Name = "analysisBudget";
+            typedef std::map<std::string, uint64_t> Type;
+        };
+
+        /// \brief Auxiliary data listing the degradations (e.g. `skipped:SCC-analysis`)
+        /// applied to meet the `--deadline` or the `--max-memory` limit.
+        struct DdisasmDegradations
+        {
+            static constexpr const char* Name = "ddisasmDegradations";
+            typedef std::vector<std::string> Type;
+        };
+
         /// \brief Auxiliary data mapping PE load configuration field names to number values.
         struct PeLoadConfig
         {
@@ -22,6 +22,17 @@
 //===----------------------------------------------------------------------===//
 #include "CliDriver.h"
 
+#include <algorithm>
+#include <sstream>
+
+#if defined(_MSC_VER)
+#include <windows.h>
+// windows.h must come first.
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
 // Define CLI output field widths
 constexpr size_t IndentWidth = 4;
 constexpr size_t TimeWidth = 8;
@@ -64,6 +75,30 @@ void printElapsedTimeSince(std::chrono::time_point<std::chrono::high_resolution_
     printElapsedTime(End - Start);
 }
 
+static std::string jsonString(const std::string &Str)
+{
+    std::stringstream Out;
+    Out << '"';
+    for(unsigned char C : Str)
+    {
+        if(C == '"' || C == '\\')
+        {
+            Out << '\\' << C;
+        }
+        else if(C < 0x20)
+        {
+            Out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(C)
+                << std::dec << std::setfill(' ');
+        }
+        else
+        {
+            Out << C;
+        }
+    }
+    Out << '"';
+    return Out.str();
+}
+
 void DDisasmPipelineListener::notifyPassBegin(const AnalysisPass &Pass)
 {
     std::cerr << std::setw(IndentWidth) << "" << std::left << std::setw(PassNameWidth)
@@ -143,3 +178,169 @@ void DDisasmPipelineListener::notifyPassResult(AnalysisPassPhase Phase,
                   << "";
     }
 }
+
+static const char *phaseName(AnalysisPassPhase Phase)
+{
+    switch(Phase)
+    {
+        case AnalysisPassPhase::LOAD:
+            return "load";
+        case AnalysisPassPhase::ANALYZE:
+            return "analyze";
+        case AnalysisPassPhase::TRANSFORM:
+            return "transform";
+    }
+    return "";
+}
+
+// Write relation sizes as a JSON list of {"name", "tuples"} objects.
+static void writeRelations(std::ostream &Stream,
+                           const std::vector<std::pair<std::string, size_t>> &Relations)
+{
+    Stream << "[";
+    for(size_t I = 0; I < Relations.size(); ++I)
+    {
+        Stream << (I ? ", " : "") << "{\"name\": " << jsonString(Relations[I].first)
+               << ", \"tuples\": " << Relations[I].second << "}";
+    }
+    Stream << "]";
+}
+
+void DDisasmPipelineListener::notifyMemoryLimit(const MemoryLimitReport &Report)
+{
+    // A single line of JSON, for the tools that supervise ddisasm.
+    std::stringstream Error;
+    Error << "{\"pass\": " << jsonString(Report.Pass) << ", \"phase\": \""
+          << phaseName(Report.Phase) << "\", \"rss_mib\": " << (Report.ResidentSetSize >> 20)
+          << ", \"limit_mib\": " << (Report.Limit >> 20);
+    if(!Report.LargestRelations.empty())
+    {
+        Error << ", \"largest_relations\": {\"pass\": " << jsonString(Report.RelationsPass)
+              << ", \"phase\": \"" << phaseName(Report.RelationsPhase) << "\", \"relations\": ";
+        writeRelations(Error, Report.LargestRelations);
+        Error << "}";
+    }
+    Error << "}";
+    std::cerr << "\nERROR: memory limit exceeded: " << Error.str() << "\n" << std::flush;
+}
+
+void DDisasmPipelineListener::notifyPassSkipped(const AnalysisPass &Pass)
+{
+    std::cerr << std::setw(IndentWidth) << "" << std::left << std::setw(PassNameWidth)
+              << Pass.getName() << "skipped to meet the deadline\n";
+}
+
+size_t getPeakResidentSetSize()
+{
+#if defined(_MSC_VER)
+    PROCESS_MEMORY_COUNTERS Counters;
+    if(GetProcessMemoryInfo(GetCurrentProcess(), &Counters, sizeof(Counters)))
+    {
+        return Counters.PeakWorkingSetSize / 1024;
+    }
+    return 0;
+#else
+    struct rusage Usage;
+    if(getrusage(RUSAGE_SELF, &Usage) != 0)
+    {
+        return 0;
+    }
+#if defined(__APPLE__)
+    // macOS reports bytes instead of KiB.
+    return Usage.ru_maxrss / 1024;
+#else
+    return Usage.ru_maxrss;
+#endif
+#endif
+}
+
+void StatsPipelineListener::beginModule(const std::string &Name)
+{
+    Modules.push_back({Name, {}});
+}
+
+void StatsPipelineListener::addStage(const std::string &Name,
+                                     std::chrono::duration<double> Elapsed)
+{
+    Stages.emplace_back(Name, Elapsed.count());
+}
+
+void StatsPipelineListener::notifyPassBegin(const AnalysisPass &Pass)
+{
+    if(Modules.empty())
+    {
+        beginModule("");
+    }
+    Modules.back().Passes.push_back({Pass.getNameSlug()});
+}
+
+void StatsPipelineListener::notifyPassEnd([[maybe_unused]] const AnalysisPass &Pass)
+{
+}
+
+void StatsPipelineListener::notifyPassPhase([[maybe_unused]] AnalysisPassPhase Phase,
+                                            [[maybe_unused]] bool HasPhase)
+{
+}
+
+void StatsPipelineListener::notifyPassResult(AnalysisPassPhase Phase,
+                                             const AnalysisPassResult &Result)
+{
+    PassStats &Pass = Modules.back().Passes.back();
+    Pass.PeakMemory = std::max(Pass.PeakMemory, Result.PeakMemory);
+    for(const auto &[Name, Tuples] : Result.LargestRelations)
+    {
+        Pass.Relations[Name] = std::max(Pass.Relations[Name], Tuples);
+    }
+    switch(Phase)
+    {
+        case AnalysisPassPhase::LOAD:
+            Pass.Load = Result.RunTime.count();
+            break;
+        case AnalysisPassPhase::ANALYZE:
+            Pass.Analyze = Result.RunTime.count();
+            break;
+        case AnalysisPassPhase::TRANSFORM:
+            Pass.Transform = Result.RunTime.count();
+            break;
+    }
+}
+
+void StatsPipelineListener::write(std::ostream &Stream, unsigned int Threads) const
+{
+    Stream << "{\n  \"threads\": " << Threads << ",\n";
+    Stream << "  \"peak_rss_kb\": " << getPeakResidentSetSize() << ",\n";
+    Stream << "  \"stages\": {";
+    for(size_t I = 0; I < Stages.size(); ++I)
+    {
+        Stream << (I ? ", " : "") << jsonString(Stages[I].first) << ": " << Stages[I].second;
+    }
+    Stream << "},\n  \"modules\": [";
+    for(size_t I = 0; I < Modules.size(); ++I)
+    {
+        const ModuleStats &Module = Modules[I];
+        Stream << (I ? "," : "") << "\n    {\"name\": " << jsonString(Module.Name)
+               << ", \"passes\": [";
+        for(size_t J = 0; J < Module.Passes.size(); ++J)
+        {
+            const PassStats &Pass = Module.Passes[J];
+            Stream << (J ? "," : "") << "\n      {\"name\": " << jsonString(Pass.Name)
+                   << ", \"load\": " << Pass.Load << ", \"analyze\": " << Pass.Analyze
+                   << ", \"transform\": " << Pass.Transform
+                   << ", \"peak_rss_kb\": " << (Pass.PeakMemory >> 10);
+            if(!Pass.Relations.empty())
+            {
+                std::vector<std::pair<std::string, size_t>> Relations(Pass.Relations.begin(),
+                                                                      Pass.Relations.end());
+                std::stable_sort(
+                    Relations.begin(), Relations.end(),
+                    [](const auto &A, const auto &B) { return A.second > B.second; });
+                Stream << ", \"largest_relations\": ";
+                writeRelations(Stream, Relations);
+            }
+            Stream << "}";
+        }
+        Stream << "\n    ]}";
+    }
+    Stream << "\n  ]\n}\n";
+}
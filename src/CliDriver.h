@@ -25,6 +25,10 @@
 
 #include <chrono>
 #include <iomanip>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
 
 #include "AnalysisPipeline.h"
 #include "passes/AnalysisPass.h"
@@ -33,6 +37,9 @@ void printElapsedTime(std::chrono::duration<double> Elapsed);
 void printElapsedTimeSince(std::chrono::time_point<std::chrono::high_resolution_clock> Start);
 bool printPassResults(const AnalysisPassResult& Result);
 
+// Peak resident set size of this process in KiB, or 0 if it is not available.
+size_t getPeakResidentSetSize();
+
 class DDisasmPipelineListener : public AnalysisPipelineListener
 {
 public:
@@ -44,6 +51,54 @@ public:
     virtual void notifyPassEnd(const AnalysisPass& Pass);
     virtual void notifyPassPhase(AnalysisPassPhase Phase, bool HasPhase);
     virtual void notifyPassResult(AnalysisPassPhase Phase, const AnalysisPassResult& Result);
+    virtual void notifyMemoryLimit(const MemoryLimitReport& Report);
+    virtual void notifyPassSkipped(const AnalysisPass& Pass);
+};
+
+/**
+Records the run time of every pass phase for the `--stats' option, and writes
+them as a JSON document for the performance regression scripts in `tests/'.
+*/
+class StatsPipelineListener : public AnalysisPipelineListener
+{
+public:
+    virtual ~StatsPipelineListener()
+    {
+    }
+
+    // Start recording the passes of a new module.
+    void beginModule(const std::string& Name);
+
+    // Record the run time of a top-level stage (e.g. "build" or "output").
+    void addStage(const std::string& Name, std::chrono::duration<double> Elapsed);
+
+    void write(std::ostream& Stream, unsigned int Threads) const;
+
+    virtual void notifyPassBegin(const AnalysisPass& Pass);
+    virtual void notifyPassEnd(const AnalysisPass& Pass);
+    virtual void notifyPassPhase(AnalysisPassPhase Phase, bool HasPhase);
+    virtual void notifyPassResult(AnalysisPassPhase Phase, const AnalysisPassResult& Result);
+
+private:
+    struct PassStats
+    {
+        std::string Name;
+        double Load = 0;
+        double Analyze = 0;
+        double Transform = 0;
+        uint64_t PeakMemory = 0;
+        // Most tuples of the largest relations at the end of a phase.
+        std::map<std::string, size_t> Relations;
+    };
+
+    struct ModuleStats
+    {
+        std::string Name;
+        std::vector<PassStats> Passes;
+    };
+
+    std::vector<std::pair<std::string, double>> Stages;
+    std::vector<ModuleStats> Modules;
 };
 
 #endif /* _CLI_DRIVER_H_ */
@@ -166,7 +166,7 @@ int main(int argc, char **argv)
     Pipeline.push<NoReturnPass>();
     Pipeline.push<FunctionInferencePass>();
 
-    Pipeline.setDatalogThreadCount(vm["threads"].as<unsigned int>());
+    Pipeline.setThreadCount(vm["threads"].as<unsigned int>());
 
     auto Modules = IR->modules();
 
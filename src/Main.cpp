@@ -23,8 +23,14 @@
 #include <fcntl.h>
 
 #include <chrono>
+#include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <sstream>
 #include <string>
 #include <thread>
 #include <vector>
@@ -52,6 +58,8 @@
 #include "Registration.h"
 #include "Version.h"
 #include "gtirb-builder/GtirbBuilder.h"
+#include "gtirb-decoder/Executor.h"
+#include "gtirb-decoder/ProgramPool.h"
 #include "passes/DisassemblyPass.h"
 #include "passes/FunctionInferencePass.h"
 #include "passes/NoReturnPass.h"
@@ -111,6 +119,39 @@ static void checkPathIsWritable(const std::string &Path)
     }
 }
 
+// Parse a size in MiB, or with a K, M, G or T suffix, into bytes.
+static std::optional<uint64_t> parseMemorySize(const std::string &Size)
+{
+    size_t End = 0;
+    uint64_t Value = 0;
+    try
+    {
+        Value = std::stoull(Size, &End);
+    }
+    catch(const std::exception &)
+    {
+        return std::nullopt;
+    }
+    std::string Suffix = Size.substr(End);
+    if(Suffix.empty() || Suffix == "M")
+    {
+        return Value << 20;
+    }
+    if(Suffix == "K")
+    {
+        return Value << 10;
+    }
+    if(Suffix == "G")
+    {
+        return Value << 30;
+    }
+    if(Suffix == "T")
+    {
+        return Value << 40;
+    }
+    return std::nullopt;
+}
+
 static void checkOutputParamIsWritable(const po::variables_map &Vars, const std::string &VarName)
 {
     if(Vars.count(VarName) != 0)
@@ -125,6 +166,7 @@ static void checkOutputParamIsWritable(const po::variables_map &Vars, const std:
 
 int main(int argc, char **argv)
 {
+    auto StartMain = std::chrono::high_resolution_clock::now();
     registerAuxDataTypes();
     registerDatalogLoaders();
     gtirb_pprint::registerPrettyPrinters();
@@ -153,7 +195,29 @@ int main(int argc, char **argv)
         "no-cfi-directives",
         "Do not produce cfi directives. Instead it produces symbolic expressions in .eh_frame "
         "(this functionality is experimental and does not produce reliable results).")(
+        "trust-relocations",
+        "Take symbolic expressions from relocations as final and skip heuristic symbolization "
+        "for the code and data they cover. This option only pays off if the target binary "
+        "contains complete relocation information (object files or --emit-relocs binaries).")(
+        "prune-superset",
+        "Decode only the linear-sweep offsets inside functions with known boundaries (from the "
+        "symbol table and .eh_frame) instead of every byte offset.")(
+        "analysis-budget", po::value<std::string>()->default_value("auto"),
+        "Bound the value analyses: 'low', 'normal', 'high', or 'auto' to choose from the binary "
+        "size.")(
         "threads,j", po::value<unsigned int>()->default_value(1), "Number of cores to use.")(
+        "max-memory", po::value<std::string>(),
+        "Exit with an error naming the running pass if the memory usage exceeds this size (in "
+        "MiB, or with a K, M, G or T suffix). Close to the limit, the next passes use fewer "
+        "threads and a lower analysis budget.")(
+        "deadline", po::value<double>(),
+        "Try to finish the analyses within this many seconds: when there is not enough time "
+        "left, use a lower analysis budget and skip the function analyses. The applied "
+        "degradations are listed in the ddisasmDegradations AuxData table.")(
+        "reuse-programs",
+        "Reuse the Souffle programs of the previous modules of an archive instead of building "
+        "new ones. The symbols of the previous modules are kept, which can change the order in "
+        "which ties are broken in the output of a module.")(
         "generate-import-libs", "Generated .DEF and .LIB files for imported libraries (PE).")(
         "generate-resources", "Generated .RES files for embedded resources (PE).")(
         "no-analysis,n",
@@ -163,7 +227,11 @@ int main(int argc, char **argv)
         "library-dir,L", po::value<std::string>(),
         "Directory from which extra libraries are loaded when running the interpreter")(
         "profile", po::value<std::string>()->default_value(""),
-        "Generate Souffle profiling information in the specified directory.");
+        "Generate Souffle profiling information in the specified directory. Unless ddisasm is "
+        "built with DDISASM_SOUFFLE_PROFILING or run with --interpreter, the profile is sampled "
+        "and attributed to Souffle strata.")(
+        "stats", po::value<std::string>(),
+        "Write the run time of each pass and the peak memory usage to the specified JSON file.");
 
     po::positional_options_description pd;
     pd.add("input-file", -1);
@@ -208,17 +276,36 @@ int main(int argc, char **argv)
         return 1;
     }
 
-    const std::string &ProfileDir = vm["profile"].as<std::string>();
-#if !defined(DDISASM_SOUFFLE_PROFILING)
-    if(!ProfileDir.empty() && !vm.count("interpreter"))
+    const std::string &AnalysisBudget = vm["analysis-budget"].as<std::string>();
+    if(!DisassemblyPass::isAnalysisBudget(AnalysisBudget))
     {
-        std::cerr << "Error: missing `--interpreter' argument required by `--profile'\n";
+        std::cerr << "Error: invalid `--analysis-budget' level: " << AnalysisBudget << "\n";
         return 1;
     }
-#endif
+
+    std::optional<uint64_t> MaxMemory;
+    if(vm.count("max-memory"))
+    {
+        MaxMemory = parseMemorySize(vm["max-memory"].as<std::string>());
+        if(!MaxMemory || *MaxMemory == 0)
+        {
+            std::cerr << "Error: invalid `--max-memory' size: "
+                      << vm["max-memory"].as<std::string>() << "\n";
+            return 1;
+        }
+    }
+
+    if(vm.count("deadline") && vm["deadline"].as<double>() < 0)
+    {
+        std::cerr << "Error: invalid `--deadline': " << vm["deadline"].as<double>() << "\n";
+        return 1;
+    }
+
+    const std::string &ProfileDir = vm["profile"].as<std::string>();
 
     checkOutputParamIsWritable(vm, "ir");
     checkOutputParamIsWritable(vm, "json");
+    checkOutputParamIsWritable(vm, "stats");
 
     // Parse and build a GTIRB module from a supported binary object file.
     std::cerr << "Building the initial gtirb representation " << std::flush;
@@ -249,6 +336,8 @@ int main(int argc, char **argv)
     GTIRB->IR->addAuxData<gtirb::schema::DdisasmVersion>(DDISASM_FULL_VERSION_STRING);
     printElapsedTimeSince(StartBuildZeroIR);
     std::cerr << "\n";
+    auto Stats = std::make_shared<StatsPipelineListener>();
+    Stats->addStage("build", std::chrono::high_resolution_clock::now() - StartBuildZeroIR);
 
     if(!GTIRB->IR)
     {
@@ -275,8 +364,15 @@ int main(int argc, char **argv)
 
     AnalysisPipeline Pipeline;
     Pipeline.addListener(std::make_shared<DDisasmPipelineListener>());
+    if(vm.count("stats"))
+    {
+        Pipeline.addListener(Stats);
+        Pipeline.enableRelationSizes();
+    }
     Pipeline.push<DisassemblyPass>(vm.count("self-diagnose") != 0, vm.count("ignore-errors") != 0,
-                                   vm.count("no-cfi-directives") != 0);
+                                   vm.count("no-cfi-directives") != 0,
+                                   vm.count("trust-relocations") != 0,
+                                   vm.count("prune-superset") != 0, AnalysisBudget);
 
     if(vm.count("skip-function-analysis") == 0)
     {
@@ -285,7 +381,18 @@ int main(int argc, char **argv)
         Pipeline.push<FunctionInferencePass>();
     }
 
-    Pipeline.setDatalogThreadCount(vm["threads"].as<unsigned int>());
+    Pipeline.setThreadCount(vm["threads"].as<unsigned int>());
+    if(MaxMemory)
+    {
+        Pipeline.setMaxMemory(*MaxMemory);
+    }
+    if(vm.count("deadline"))
+    {
+        std::chrono::duration<double> Seconds(vm["deadline"].as<double>());
+        Pipeline.setDeadline(
+            StartMain
+            + std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(Seconds));
+    }
     if(!ProfileDir.empty())
     {
         fs::create_directories(ProfileDir);
@@ -316,16 +423,41 @@ int main(int argc, char **argv)
         Pipeline.enableSouffleOutputs();
     }
 
+    if(vm.count("reuse-programs") != 0)
+    {
+        ProgramPool::instance().setCapacity(ProgramPool::ReuseCapacity);
+    }
+
+    auto StartAnalysis = std::chrono::high_resolution_clock::now();
     for(auto &Module : Modules)
     {
         std::cerr << "Processing module: " << Module.getName() << "\n";
+        Stats->beginModule(Module.getName());
         Pipeline.run(*GTIRB->Context, Module);
 
         // Remove provisional AuxData tables.
         Module.removeAuxData<gtirb::schema::Relocations>();
         Module.removeAuxData<gtirb::schema::SectionIndex>();
     }
-
+    ProgramPool::instance().clear();
+    auto StartOutput = std::chrono::high_resolution_clock::now();
+    Stats->addStage("analysis", StartOutput - StartAnalysis);
+
+    // Files are written by OutputTasks, which run concurrently with the
+    // printing of the modules to their .s files.
+    Executor OutputExecutor(vm["threads"].as<unsigned int>());
+    std::vector<std::function<void()>> OutputTasks;
+    // The buffer is moved into the task, so its contents are not copied.
+    auto WriteLater = [&OutputTasks](const std::string &Name, std::ios::openmode Mode,
+                                     std::stringstream &&Buffer) {
+        auto Contents = std::make_shared<std::stringstream>(std::move(Buffer));
+        OutputTasks.push_back([Name, Mode, Contents]() {
+            std::ofstream out(Name, Mode);
+            out << Contents->rdbuf();
+        });
+    };
+
+    // The IR is serialized here, before the pretty-printer fixups modify it.
     // Output GTIRB
     if(vm.count("ir") != 0)
     {
@@ -337,8 +469,9 @@ int main(int argc, char **argv)
         }
         else
         {
-            std::ofstream out(name, std::ios::out | std::ios::binary);
-            GTIRB->IR->save(out);
+            std::stringstream Buffer(std::ios::in | std::ios::out | std::ios::binary);
+            GTIRB->IR->save(Buffer);
+            WriteLater(name, std::ios::out | std::ios::binary, std::move(Buffer));
         }
     }
     // Output json GTIRB
@@ -351,11 +484,24 @@ int main(int argc, char **argv)
         }
         else
         {
-            std::ofstream out(name);
-            GTIRB->IR->saveJSON(out);
+            std::stringstream Buffer;
+            GTIRB->IR->saveJSON(Buffer);
+            WriteLater(name, std::ios::out, std::move(Buffer));
         }
     }
 
+    auto RunOutputTasks = [&]() {
+        if(!OutputTasks.empty())
+        {
+            std::cerr << "Writing output files " << std::flush;
+            auto StartWriting = std::chrono::high_resolution_clock::now();
+            OutputExecutor.run(OutputTasks);
+            OutputTasks.clear();
+            printElapsedTimeSince(StartWriting);
+            std::cerr << "\n";
+        }
+    };
+
     gtirb_pprint::PrettyPrinter pprinter;
 
     // Output PE-specific build artifacts.
@@ -380,52 +526,77 @@ int main(int argc, char **argv)
     if(vm.count("asm") != 0 || (vm.count("ir") == 0 && vm.count("json") == 0))
     {
         std::string ListingMode = vm.count("debug") != 0 ? "debug" : "";
+        std::vector<std::string> KeepFunctions;
+        if(vm.count("keep-functions") != 0)
+        {
+            KeepFunctions = vm["keep-functions"].as<std::vector<std::string>>();
+        }
+        // Apply pre-print transforms provided by the pretty-printer library.
+        // This MODIFIES the GTIRB, so it's important to do this *after*
+        // serializing the GTIRB output if we're doing both. The fixups modify
+        // the shared context, so every module is fixed up before any module is
+        // printed.
+        std::map<const gtirb::Module *, gtirb_pprint::PrettyPrinter> Printers;
         for(auto &Module : Modules)
         {
+            gtirb_pprint::PrettyPrinter &Printer = Printers[&Module];
             const std::string &format = gtirb_pprint::getModuleFileFormat(Module);
             const std::string &isa = gtirb_pprint::getModuleISA(Module);
             const std::string &syntax =
                 gtirb_pprint::getDefaultSyntax(format, isa, ListingMode).value_or("");
             auto target = std::make_tuple(format, isa, syntax);
-            pprinter.setTarget(std::move(target));
+            Printer.setTarget(std::move(target));
 
-            // Apply pre-print transforms provided by the pretty-printer library.
-            // This MODIFIES the GTIRB, so it's important to do this *after*
-            // writing the GTIRB output to disk if we're doing both.
-            gtirb_pprint::applyFixups(*GTIRB->Context, Module, pprinter);
+            gtirb_pprint::applyFixups(*GTIRB->Context, Module, Printer);
 
-            if(vm.count("debug") != 0)
+            if(!ListingMode.empty())
             {
-                pprinter.setListingMode("debug");
+                Printer.setListingMode(ListingMode);
             }
 
-            if(vm.count("keep-functions") != 0)
+            for(const std::string &keep : KeepFunctions)
             {
-                for(auto keep : vm["keep-functions"].as<std::vector<std::string>>())
-                {
-                    pprinter.symbolPolicy().keep(keep);
-                }
+                Printer.symbolPolicy().keep(keep);
             }
+        }
+        auto PrintModule = [&](gtirb::Module &Module, std::ostream &Stream) {
+            Printers.at(&Module).print(Stream, *GTIRB->Context, Module);
+        };
 
-            fs::path AsmPath;
-            std::ofstream AsmFileStream;
-            bool UseStdout = true;
-            if(vm.count("asm") != 0)
+        fs::path AsmPath;
+        if(vm.count("asm") != 0)
+        {
+            std::string name = vm["asm"].as<std::string>();
+            if(name != "-")
             {
-                std::string name = vm["asm"].as<std::string>();
-                if(name != "-")
-                {
-                    AsmPath = name;
-                }
+                AsmPath = name;
             }
+        }
 
-            if(!AsmPath.empty())
+        if(AsmPath.empty())
+        {
+            for(auto &Module : Modules)
+            {
+                std::cerr << "Printing assembler " << std::flush;
+                auto StartPrinting = std::chrono::high_resolution_clock::now();
+                PrintModule(Module, std::cout);
+                printElapsedTimeSince(StartPrinting);
+                std::cerr << "\n";
+            }
+        }
+        else
+        {
+            // If there are multiple modules, use the asm argument as a directory.
+            // Each module will get its own .s file.
+            if(ModuleCount > 1)
             {
-                // If there are multiple modules, use the asm argument as a directory.
-                // Each module will get its own .s file.
+                fs::create_directories(AsmPath);
+            }
+            for(auto &Module : Modules)
+            {
+                fs::path ModuleAsmPath = AsmPath;
                 if(ModuleCount > 1)
                 {
-                    fs::create_directories(AsmPath);
                     std::string name = Module.getName();
 
                     // Strip ".o" extension if it exists.
@@ -433,20 +604,28 @@ int main(int argc, char **argv)
                     {
                         name.erase(name.size() - 2);
                     }
-                    AsmPath /= name + ".s";
+                    ModuleAsmPath /= name + ".s";
                 }
-                AsmFileStream.open(AsmPath.string());
-                UseStdout = false;
+                OutputTasks.push_back([&PrintModule, &Module, ModuleAsmPath]() {
+                    std::ofstream AsmFileStream(ModuleAsmPath.string());
+                    PrintModule(Module, AsmFileStream);
+                });
             }
-
-            std::cerr << "Printing assembler " << std::flush;
-            auto StartPrinting = std::chrono::high_resolution_clock::now();
-            pprinter.print(UseStdout ? std::cout : AsmFileStream, *GTIRB->Context, Module);
-            printElapsedTimeSince(StartPrinting);
-            std::cerr << "\n";
+            RunOutputTasks();
         }
     }
 
+    RunOutputTasks();
+
+    if(vm.count("stats"))
+    {
+        auto EndMain = std::chrono::high_resolution_clock::now();
+        Stats->addStage("output", EndMain - StartOutput);
+        Stats->addStage("total", EndMain - StartMain);
+        std::ofstream StatsStream(vm["stats"].as<std::string>());
+        Stats->write(StatsStream, vm["threads"].as<unsigned int>());
+    }
+
     if(GTIRB)
     {
         GTIRB->Context->ForgetAllocations();
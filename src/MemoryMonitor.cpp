@@ -0,0 +1,130 @@
+//===- MemoryMonitor.cpp ----------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the GNU Affero General Public License
+//  as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version. See the
+//  LICENSE.txt file in the project root for license terms or visit
+//  https://www.gnu.org/licenses/agpl.txt.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU Affero General Public License for more details.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include "MemoryMonitor.h"
+
+#include <algorithm>
+#include <fstream>
+
+#if defined(_MSC_VER)
+#include <windows.h>
+// windows.h must come first.
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#endif
+
+uint64_t getResidentSetSize()
+{
+#if defined(_MSC_VER)
+    PROCESS_MEMORY_COUNTERS Counters;
+    if(GetProcessMemoryInfo(GetCurrentProcess(), &Counters, sizeof(Counters)))
+    {
+        return Counters.WorkingSetSize;
+    }
+    return 0;
+#elif defined(__APPLE__)
+    mach_task_basic_info_data_t Info;
+    mach_msg_type_number_t Count = MACH_TASK_BASIC_INFO_COUNT;
+    if(task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&Info),
+                 &Count)
+       == KERN_SUCCESS)
+    {
+        return Info.resident_size;
+    }
+    return 0;
+#elif defined(__linux__)
+    // The second field of statm is the number of resident pages.
+    std::ifstream Statm("/proc/self/statm");
+    uint64_t Size = 0, Resident = 0;
+    if(Statm >> Size >> Resident)
+    {
+        return Resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    }
+    return 0;
+#else
+    return 0;
+#endif
+}
+
+MemoryMonitor::~MemoryMonitor()
+{
+    stop();
+}
+
+void MemoryMonitor::setLimit(uint64_t Bytes, LimitHandler H)
+{
+    Limit = Bytes;
+    Handler = std::move(H);
+}
+
+void MemoryMonitor::start()
+{
+    if(Sampler.joinable())
+    {
+        return;
+    }
+    resetPeak();
+    StopRequested = false;
+    Sampler = std::thread([this]() {
+        std::unique_lock<std::mutex> Lock(Mutex);
+        while(!Wakeup.wait_for(Lock, Interval, [this]() { return StopRequested; }))
+        {
+            sample();
+        }
+    });
+}
+
+void MemoryMonitor::stop()
+{
+    if(!Sampler.joinable())
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        StopRequested = true;
+    }
+    Wakeup.notify_one();
+    Sampler.join();
+}
+
+void MemoryMonitor::sample()
+{
+    uint64_t Size = getResidentSetSize();
+    uint64_t Previous = Peak.load();
+    while(Size > Previous && !Peak.compare_exchange_weak(Previous, Size))
+    {
+    }
+    if(Limit != 0 && Size > Limit && Handler)
+    {
+        Handler(Size);
+    }
+}
+
+uint64_t MemoryMonitor::resetPeak()
+{
+    uint64_t Size = getResidentSetSize();
+    return std::max(Peak.exchange(Size), Size);
+}
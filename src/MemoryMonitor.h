@@ -0,0 +1,83 @@
+//===- MemoryMonitor.h ------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the GNU Affero General Public License
+//  as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version. See the
+//  LICENSE.txt file in the project root for license terms or visit
+//  https://www.gnu.org/licenses/agpl.txt.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU Affero General Public License for more details.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#ifndef _MEMORY_MONITOR_H_
+#define _MEMORY_MONITOR_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Resident set size of this process in bytes, or 0 if it is not available.
+uint64_t getResidentSetSize();
+
+/**
+Samples the resident set size of the process in a background thread while it
+runs. It keeps the peak since the last reset and calls a handler, from the
+sampling thread, when the resident set size exceeds a limit.
+*/
+class MemoryMonitor
+{
+public:
+    using LimitHandler = std::function<void(uint64_t ResidentSetSize)>;
+
+    explicit MemoryMonitor(std::chrono::milliseconds Interval = std::chrono::milliseconds(20))
+        : Interval(Interval)
+    {
+    }
+    ~MemoryMonitor();
+
+    MemoryMonitor(const MemoryMonitor&) = delete;
+    MemoryMonitor& operator=(const MemoryMonitor&) = delete;
+
+    // Call Handler when the resident set size exceeds Bytes (0 for no limit).
+    void setLimit(uint64_t Bytes, LimitHandler Handler);
+    uint64_t getLimit() const
+    {
+        return Limit;
+    }
+
+    void start();
+    void stop();
+
+    // Return the peak resident set size since the last reset, and reset it.
+    uint64_t resetPeak();
+
+private:
+    void sample();
+
+    std::chrono::milliseconds Interval;
+    uint64_t Limit = 0;
+    LimitHandler Handler;
+    std::atomic<uint64_t> Peak{0};
+
+    std::thread Sampler;
+    std::mutex Mutex;
+    std::condition_variable Wakeup;
+    bool StopRequested = false;
+};
+
+#endif /* _MEMORY_MONITOR_H_ */
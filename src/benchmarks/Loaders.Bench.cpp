@@ -0,0 +1,532 @@
+//===- Loaders.Bench.cpp ----------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the GNU Affero General Public License
+//  as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version. See the
+//  LICENSE.txt file in the project root for license terms or visit
+//  https://www.gnu.org/licenses/agpl.txt.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU Affero General Public License for more details.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <gtirb/gtirb.hpp>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../AuxDataSchema.h"
+#include "../Registration.h"
+#include "../gtirb-builder/GtirbBuilder.h"
+#include "../gtirb-decoder/CompositeLoader.h"
+#include "../gtirb-decoder/ProgramPool.h"
+#include "../gtirb-decoder/Relations.h"
+#include "../gtirb-decoder/core/DataLoader.h"
+#include "../gtirb-decoder/format/ElfLoader.h"
+#if defined(DDISASM_ARM_32)
+#include "../gtirb-decoder/arch/Arm32Loader.h"
+#endif
+#if defined(DDISASM_ARM_64)
+#include "../gtirb-decoder/arch/Arm64Loader.h"
+#endif
+#if defined(DDISASM_MIPS_32)
+#include "../gtirb-decoder/arch/Mips32Loader.h"
+#endif
+#if defined(DDISASM_X86_32)
+#include "../gtirb-decoder/arch/X86Loader.h"
+#endif
+#if defined(DDISASM_X86_64)
+#include "../gtirb-decoder/arch/X64Loader.h"
+#endif
+
+// Benchmarks for the gtirb-decoder loaders.
+//
+// Besides the Google Benchmark flags, ddisasm_bench accepts:
+//   --input=<binary>    also run the loaders on the module of a real binary
+//   --min-size=<bytes>  smallest synthetic buffer (default 4 KiB)
+//   --max-size=<bytes>  largest synthetic buffer (default 1 MiB)
+//   --members=<count>   modules per iteration of the BM_members benchmarks,
+//                       as in an archive (default 500); the /run variants
+//                       also evaluate the program on each module
+// For the symbol and insert benchmarks, the size is a number of facts.
+
+struct BenchOptions
+{
+    std::string Input;
+    int64_t MinSize = 4 << 10;
+    int64_t MaxSize = 1 << 20;
+    int64_t Members = 500;
+};
+
+struct BenchModule
+{
+    std::shared_ptr<gtirb::Context> Context;
+    gtirb::Module *Module;
+};
+
+struct ArchLoader
+{
+    std::string Name;
+    gtirb::ISA ISA;
+    gtirb::ByteOrder ByteOrder;
+    std::string ProgramName;
+    CompositeLoader::Loader Fn;
+};
+
+static std::vector<ArchLoader> archLoaders()
+{
+    std::vector<ArchLoader> Loaders;
+#if defined(DDISASM_X86_64)
+    Loaders.push_back({"X64Loader", gtirb::ISA::X64, gtirb::ByteOrder::Little,
+                       "souffle_disasm_x86_64", X64Loader()});
+#endif
+#if defined(DDISASM_X86_32)
+    Loaders.push_back({"X86Loader", gtirb::ISA::IA32, gtirb::ByteOrder::Little,
+                       "souffle_disasm_x86_32", X86Loader()});
+#endif
+#if defined(DDISASM_ARM_32)
+    Loaders.push_back({"Arm32Loader", gtirb::ISA::ARM, gtirb::ByteOrder::Little,
+                       "souffle_disasm_arm32", Arm32Loader()});
+#endif
+#if defined(DDISASM_ARM_64)
+    Loaders.push_back({"Arm64Loader", gtirb::ISA::ARM64, gtirb::ByteOrder::Little,
+                       "souffle_disasm_arm64", Arm64Loader()});
+#endif
+#if defined(DDISASM_MIPS_32)
+    Loaders.push_back({"Mips32Loader", gtirb::ISA::MIPS32, gtirb::ByteOrder::Big,
+                       "souffle_disasm_mips32", Mips32Loader(Mips32Loader::Endian::BIG)});
+#endif
+    return Loaders;
+}
+
+// Build a module with a single section of Size random bytes and SymbolCount
+// symbols spread over it.
+static BenchModule buildModule(gtirb::ISA ISA, gtirb::ByteOrder ByteOrder, size_t Size,
+                               bool Executable, size_t SymbolCount = 0)
+{
+    auto Context = std::make_shared<gtirb::Context>();
+    gtirb::IR *IR = gtirb::IR::Create(*Context);
+    gtirb::Module *Module = gtirb::Module::Create(*Context, "BenchModule");
+    IR->addModule(Module);
+
+    Module->setFileFormat(gtirb::FileFormat::ELF);
+    Module->setISA(ISA);
+    Module->setByteOrder(ByteOrder);
+
+    std::vector<std::string> BinaryType = {"EXEC"};
+    Module->addAuxData<gtirb::schema::BinaryType>(std::move(BinaryType));
+
+    std::mt19937_64 Random(Size);
+    std::vector<uint8_t> Bytes(Size);
+    for(uint8_t &Byte : Bytes)
+    {
+        Byte = static_cast<uint8_t>(Random());
+    }
+
+    uint64_t Addr = 0x10000;
+    gtirb::Section *S = Module->addSection(*Context, Executable ? ".text" : ".data");
+    S->addByteInterval(*Context, gtirb::Addr(Addr), Bytes.begin(), Bytes.end(), Bytes.size(),
+                       Bytes.size());
+    S->addFlag(gtirb::SectionFlag::Loaded);
+    S->addFlag(gtirb::SectionFlag::Readable);
+    S->addFlag(gtirb::SectionFlag::Initialized);
+    S->addFlag(Executable ? gtirb::SectionFlag::Executable : gtirb::SectionFlag::Writable);
+
+    for(size_t I = 0; I < SymbolCount; I++)
+    {
+        Module->addSymbol(*Context, gtirb::Addr(Addr + I % std::max<size_t>(Size, 1)),
+                          "sym_" + std::to_string(I));
+    }
+
+    return BenchModule{Context, Module};
+}
+
+static uint64_t sectionBytes(const gtirb::Module &Module, bool ExecutableOnly)
+{
+    uint64_t Bytes = 0;
+    for(const auto &Section : Module.sections())
+    {
+        if(!ExecutableOnly || Section.isFlagSet(gtirb::SectionFlag::Executable))
+        {
+            Bytes += Section.getSize().value_or(0);
+        }
+    }
+    return Bytes;
+}
+
+static uint64_t countFacts(souffle::SouffleProgram &Program)
+{
+    uint64_t Facts = 0;
+    for(souffle::Relation *Relation : Program.getInputRelations())
+    {
+        Facts += Relation->size();
+    }
+    return Facts;
+}
+
+// Run the loader on the module once per iteration, on a fresh program.
+static void runLoader(benchmark::State &State, const std::string &ProgramName,
+                      const CompositeLoader::Loader &Loader, const gtirb::Module &Module,
+                      uint64_t Bytes)
+{
+    uint64_t Facts = 0;
+    for(auto _ : State)
+    {
+        State.PauseTiming();
+        std::unique_ptr<souffle::SouffleProgram> Program(
+            souffle::ProgramFactory::newInstance(ProgramName));
+        if(!Program)
+        {
+            State.SkipWithError("Souffle program not found");
+            break;
+        }
+        State.ResumeTiming();
+
+        Loader(Module, *Program);
+
+        State.PauseTiming();
+        Facts += countFacts(*Program);
+        Program.reset();
+        State.ResumeTiming();
+    }
+    State.SetBytesProcessed(static_cast<int64_t>(State.iterations() * Bytes));
+    State.counters["facts"] =
+        benchmark::Counter(static_cast<double>(Facts), benchmark::Counter::kIsRate);
+}
+
+// Run the loader on every module once per iteration, as for the members of an
+// archive, either on fresh programs or on programs reused from a ProgramPool.
+// With Evaluate, the program also runs on the loaded facts. The time includes
+// destroying or purging the program.
+static void runMembers(benchmark::State &State, const std::string &ProgramName,
+                       const CompositeLoader::Loader &Loader,
+                       const std::vector<gtirb::Module *> &Modules, bool Pooled, bool Evaluate)
+{
+    ProgramPool Pool;
+    Pool.setCapacity(1);
+    for(auto _ : State)
+    {
+        for(const gtirb::Module *Module : Modules)
+        {
+            std::unique_ptr<souffle::SouffleProgram> Program;
+            if(Pooled)
+            {
+                Program = Pool.acquire(ProgramName);
+            }
+            else
+            {
+                Program.reset(souffle::ProgramFactory::newInstance(ProgramName));
+            }
+            if(!Program)
+            {
+                State.SkipWithError("Souffle program not found");
+                return;
+            }
+
+            Loader(*Module, *Program);
+            if(Evaluate)
+            {
+                Program->run();
+            }
+
+            if(Pooled)
+            {
+                Pool.release(std::move(Program));
+            }
+        }
+    }
+    State.counters["modules"] = benchmark::Counter(
+        static_cast<double>(State.iterations() * Modules.size()), benchmark::Counter::kIsRate);
+}
+
+static void registerMembersBenchmarks(const std::string &Name, const ArchLoader &Arch,
+                                      const std::vector<gtirb::Module *> &Modules)
+{
+    for(bool Evaluate : {false, true})
+    {
+        for(bool Pooled : {false, true})
+        {
+            std::string Benchmark =
+                "BM_members/" + Name + (Pooled ? "/pooled" : "/fresh") + (Evaluate ? "/run" : "");
+            benchmark::RegisterBenchmark(
+                Benchmark.c_str(),
+                [Arch, Modules, Pooled, Evaluate](benchmark::State &State) {
+                    runMembers(State, Arch.ProgramName, Arch.Fn, Modules, Pooled, Evaluate);
+                })
+                ->Unit(benchmark::kMillisecond);
+        }
+    }
+}
+
+// Time relations::insert alone for Count tuples built by Make.
+template <typename T>
+static void runInsert(benchmark::State &State, const std::string &ProgramName,
+                      const std::string &RelationName, T (*Make)(size_t))
+{
+    std::vector<T> Tuples;
+    for(size_t I = 0; I < static_cast<size_t>(State.range(0)); I++)
+    {
+        Tuples.push_back(Make(I));
+    }
+
+    for(auto _ : State)
+    {
+        State.PauseTiming();
+        std::unique_ptr<souffle::SouffleProgram> Program(
+            souffle::ProgramFactory::newInstance(ProgramName));
+        if(!Program)
+        {
+            State.SkipWithError("Souffle program not found");
+            break;
+        }
+        State.ResumeTiming();
+
+        relations::insert(*Program, RelationName, Tuples);
+
+        State.PauseTiming();
+        Program.reset();
+        State.ResumeTiming();
+    }
+    State.counters["facts"] = benchmark::Counter(
+        static_cast<double>(State.iterations() * Tuples.size()), benchmark::Counter::kIsRate);
+}
+
+static relations::Data<gtirb::Addr> makeAddressInData(size_t I)
+{
+    return {gtirb::Addr(0x10000 + 8 * I), gtirb::Addr(0x20000 + I)};
+}
+
+static relations::Symbol makeSymbol(size_t I)
+{
+    return {gtirb::Addr(0x10000 + I), 0, "FUNC", "GLOBAL", "DEFAULT", 1, "NONE", 0,
+            "sym_" + std::to_string(I)};
+}
+
+static DataLoader::Pointer pointerSize(gtirb::ISA ISA)
+{
+    return (ISA == gtirb::ISA::X64 || ISA == gtirb::ISA::ARM64) ? DataLoader::Pointer::QWORD
+                                                                : DataLoader::Pointer::DWORD;
+}
+
+static DataLoader::Endian dataEndian(gtirb::ByteOrder ByteOrder)
+{
+    return ByteOrder == gtirb::ByteOrder::Big ? DataLoader::Endian::BIG
+                                              : DataLoader::Endian::LITTLE;
+}
+
+static void registerSyntheticBenchmarks(const BenchOptions &Options)
+{
+    std::vector<ArchLoader> Loaders = archLoaders();
+    if(Loaders.empty())
+    {
+        return;
+    }
+
+    for(const ArchLoader &Arch : Loaders)
+    {
+        benchmark::RegisterBenchmark(("BM_" + Arch.Name + "/random").c_str(),
+                                     [Arch](benchmark::State &State) {
+                                         BenchModule M = buildModule(
+                                             Arch.ISA, Arch.ByteOrder, State.range(0), true);
+                                         runLoader(State, Arch.ProgramName, Arch.Fn, *M.Module,
+                                                   State.range(0));
+                                     })
+            ->RangeMultiplier(4)
+            ->Range(Options.MinSize, Options.MaxSize)
+            ->Unit(benchmark::kMillisecond);
+    }
+
+    // The remaining loaders do not depend on the architecture; use the
+    // program of the first one.
+    const ArchLoader &Arch = Loaders.front();
+    for(DataLoader::Pointer Pointer : {DataLoader::Pointer::DWORD, DataLoader::Pointer::QWORD})
+    {
+        std::string Name = Pointer == DataLoader::Pointer::DWORD ? "dword" : "qword";
+        benchmark::RegisterBenchmark(
+            ("BM_DataLoader/" + Name + "/random").c_str(),
+            [Arch, Pointer](benchmark::State &State) {
+                BenchModule M = buildModule(Arch.ISA, Arch.ByteOrder, State.range(0), false);
+                runLoader(State, Arch.ProgramName, DataLoader(Pointer), *M.Module,
+                          State.range(0));
+            })
+            ->RangeMultiplier(4)
+            ->Range(Options.MinSize, Options.MaxSize)
+            ->Unit(benchmark::kMillisecond);
+    }
+
+    benchmark::RegisterBenchmark("BM_ElfSymbolLoader/synthetic",
+                                 [Arch](benchmark::State &State) {
+                                     BenchModule M = buildModule(Arch.ISA, Arch.ByteOrder, 4096,
+                                                                 true, State.range(0));
+                                     runLoader(State, Arch.ProgramName, ElfSymbolLoader,
+                                               *M.Module, 0);
+                                 })
+        ->RangeMultiplier(4)
+        ->Range(Options.MinSize, Options.MaxSize)
+        ->Unit(benchmark::kMillisecond);
+
+    benchmark::RegisterBenchmark("BM_insert/address_in_data",
+                                 [Arch](benchmark::State &State) {
+                                     runInsert(State, Arch.ProgramName, "address_in_data",
+                                               makeAddressInData);
+                                 })
+        ->RangeMultiplier(4)
+        ->Range(Options.MinSize, Options.MaxSize)
+        ->Unit(benchmark::kMillisecond);
+
+    benchmark::RegisterBenchmark("BM_insert/symbol",
+                                 [Arch](benchmark::State &State) {
+                                     runInsert(State, Arch.ProgramName, "symbol", makeSymbol);
+                                 })
+        ->RangeMultiplier(4)
+        ->Range(Options.MinSize, Options.MaxSize)
+        ->Unit(benchmark::kMillisecond);
+
+    // Small modules, like the object files of a static library. The modules
+    // are kept alive by the static vector for the lifetime of the benchmarks.
+    static std::vector<BenchModule> Members;
+    std::vector<gtirb::Module *> MemberModules;
+    for(int64_t I = 0; I < Options.Members; I++)
+    {
+        Members.push_back(buildModule(Arch.ISA, Arch.ByteOrder, Options.MinSize, true, 16));
+        MemberModules.push_back(Members.back().Module);
+    }
+    registerMembersBenchmarks("synthetic", Arch, MemberModules);
+}
+
+static bool registerInputBenchmarks(const BenchOptions &Options)
+{
+    auto GTIRB = GtirbBuilder::read(Options.Input);
+    if(!GTIRB)
+    {
+        std::cerr << "ERROR: " << Options.Input << ": " << GTIRB.getError().message() << "\n";
+        return false;
+    }
+
+    BenchModule M{GTIRB->Context, &*GTIRB->IR->modules().begin()};
+    gtirb::ISA ISA = M.Module->getISA();
+    gtirb::ByteOrder ByteOrder = M.Module->getByteOrder();
+
+    std::vector<ArchLoader> Loaders = archLoaders();
+    auto It = std::find_if(Loaders.begin(), Loaders.end(),
+                           [ISA](const ArchLoader &Arch) { return Arch.ISA == ISA; });
+    if(It == Loaders.end())
+    {
+        std::cerr << "ERROR: " << Options.Input << ": unsupported ISA\n";
+        return false;
+    }
+    ArchLoader Arch = *It;
+#if defined(DDISASM_MIPS_32)
+    if(ISA == gtirb::ISA::MIPS32 && ByteOrder == gtirb::ByteOrder::Little)
+    {
+        Arch.Fn = Mips32Loader(Mips32Loader::Endian::LITTLE);
+    }
+#endif
+
+    std::vector<std::pair<std::string, CompositeLoader::Loader>> Benchmarks = {
+        {Arch.Name, Arch.Fn},
+        {"DataLoader", DataLoader(pointerSize(ISA), dataEndian(ByteOrder))}};
+    if(M.Module->getFileFormat() == gtirb::FileFormat::ELF)
+    {
+        Benchmarks.emplace_back("ElfSymbolLoader", ElfSymbolLoader);
+        Benchmarks.emplace_back("ElfExceptionLoader", ElfExceptionLoader);
+    }
+
+    for(const auto &[Name, Fn] : Benchmarks)
+    {
+        uint64_t Bytes = sectionBytes(*M.Module, Name == Arch.Name);
+        benchmark::RegisterBenchmark(("BM_" + Name + "/input").c_str(),
+                                     [M, Arch, Fn = Fn, Bytes](benchmark::State &State) {
+                                         runLoader(State, Arch.ProgramName, Fn, *M.Module,
+                                                   Bytes);
+                                     })
+            ->Unit(benchmark::kMillisecond);
+    }
+
+    // All the members of an archive with the ISA of its first member.
+    std::vector<gtirb::Module *> Modules;
+    for(gtirb::Module &Module : GTIRB->IR->modules())
+    {
+        if(Module.getISA() == ISA && Module.getByteOrder() == ByteOrder)
+        {
+            Modules.push_back(&Module);
+        }
+    }
+    // The context of the modules is kept alive by the benchmarks above.
+    if(Modules.size() > 1)
+    {
+        registerMembersBenchmarks("input", Arch, Modules);
+    }
+    return true;
+}
+
+// Remove our own flags from the command line before Google Benchmark sees it.
+static BenchOptions parseOptions(int &Argc, char **Argv)
+{
+    BenchOptions Options;
+    int Out = 1;
+    for(int I = 1; I < Argc; I++)
+    {
+        std::string Arg = Argv[I];
+        if(Arg.rfind("--input=", 0) == 0)
+        {
+            Options.Input = Arg.substr(std::strlen("--input="));
+        }
+        else if(Arg.rfind("--min-size=", 0) == 0)
+        {
+            Options.MinSize = std::stoll(Arg.substr(std::strlen("--min-size=")), nullptr, 0);
+        }
+        else if(Arg.rfind("--max-size=", 0) == 0)
+        {
+            Options.MaxSize = std::stoll(Arg.substr(std::strlen("--max-size=")), nullptr, 0);
+        }
+        else if(Arg.rfind("--members=", 0) == 0)
+        {
+            Options.Members = std::stoll(Arg.substr(std::strlen("--members=")), nullptr, 0);
+        }
+        else
+        {
+            Argv[Out++] = Argv[I];
+        }
+    }
+    Argc = Out;
+    Options.MaxSize = std::max(Options.MinSize, Options.MaxSize);
+    return Options;
+}
+
+int main(int argc, char **argv)
+{
+    registerAuxDataTypes();
+
+    BenchOptions Options = parseOptions(argc, argv);
+    registerSyntheticBenchmarks(Options);
+    if(!Options.Input.empty() && !registerInputBenchmarks(Options))
+    {
+        return EXIT_FAILURE;
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if(benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return EXIT_FAILURE;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    return EXIT_SUCCESS;
+}
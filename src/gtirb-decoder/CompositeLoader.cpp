@@ -0,0 +1,101 @@
+//===- CompositeLoader.cpp --------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the GNU Affero General Public License
+//  as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version. See the
+//  LICENSE.txt file in the project root for license terms or visit
+//  https://www.gnu.org/licenses/agpl.txt.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU Affero General Public License for more details.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//===----------------------------------------------------------------------===//
+#include "CompositeLoader.h"
+
+#include <algorithm>
+#include <cassert>
+#include <set>
+
+void CompositeLoader::run(const gtirb::Module& Module, souffle::SouffleProgram& Program,
+                          const Executor& Exec)
+{
+    relations::insert(Program, "option", Options);
+
+    std::vector<const Entry*> Group;
+    std::set<std::string> GroupProduces;
+    auto Flush = [&]() {
+        runGroup(Group, Module, Program, Exec);
+        Group.clear();
+        GroupProduces.clear();
+    };
+
+    for(const Entry& E : Loaders)
+    {
+        if(E.Fn)
+        {
+            Flush();
+            E.Fn(Module, Program);
+            continue;
+        }
+        bool Reads = E.ConsumesOption.empty()
+                     || std::find(Options.begin(), Options.end(), E.ConsumesOption)
+                            != Options.end();
+        if(Reads
+           && std::any_of(E.Consumes.begin(), E.Consumes.end(),
+                          [&](const std::string& R) { return GroupProduces.count(R) > 0; }))
+        {
+            Flush();
+        }
+        Group.push_back(&E);
+        GroupProduces.insert(E.Produces.begin(), E.Produces.end());
+    }
+    Flush();
+}
+
+void CompositeLoader::runGroup(const std::vector<const Entry*>& Group,
+                               const gtirb::Module& Module, souffle::SouffleProgram& Program,
+                               const Executor& Exec)
+{
+    // The loaders read the program and the AuxData tables in order: GTIRB
+    // decodes an AuxData table on its first access, which is not thread-safe.
+    for(const Entry* E : Group)
+    {
+        E->Prepare(Module, Program);
+    }
+
+    std::vector<Inserter> Inserters(Group.size());
+    Exec.parallelFor(Group.size(), [&](size_t I) { Inserters[I] = Group[I]->Facts(Module); });
+
+    // Insert the facts in the order the loaders were added.
+    for(size_t I = 0; I < Group.size(); I++)
+    {
+#ifndef NDEBUG
+        std::vector<std::pair<souffle::Relation*, size_t>> Sizes;
+        for(souffle::Relation* Relation : Program.getAllRelations())
+        {
+            Sizes.emplace_back(Relation, Relation->size());
+        }
+#endif
+        Inserters[I](Program);
+        Inserters[I] = nullptr;
+#ifndef NDEBUG
+        const std::vector<std::string>& Produces = Group[I]->Produces;
+        for(auto [Relation, Size] : Sizes)
+        {
+            assert((Relation->size() == Size
+                    || std::find(Produces.begin(), Produces.end(), Relation->getName())
+                           != Produces.end())
+                   && "Loader populated an undeclared relation");
+        }
+#endif
+    }
+}
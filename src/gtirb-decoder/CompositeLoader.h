@@ -23,44 +23,83 @@
 #ifndef SRC_GTIRB_DECODER_COMPOSITELOADER_H_
 #define SRC_GTIRB_DECODER_COMPOSITELOADER_H_
 
+#include <functional>
 #include <gtirb/gtirb.hpp>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
 #include "DatalogIO.h"
+#include "Executor.h"
+#include "ProgramPool.h"
 #include "Relations.h"
 
 class CompositeLoader
 {
 public:
-    explicit CompositeLoader(const std::string& N) : Name{N}, Loaders{} {};
+    explicit CompositeLoader(const std::string& N) : Name{N}, Loaders{}, Options{} {};
     ~CompositeLoader() = default;
 
     // Common type definition for functions/functors that populate datalog relations.
     using Loader = std::function<void(const gtirb::Module&, souffle::SouffleProgram&)>;
 
+    // Inserts facts computed ahead of time into a program.
+    using Inserter = std::function<void(souffle::SouffleProgram&)>;
+
     // Add function to this composite loader.
     void add(Loader Fn)
     {
-        Loaders.push_back(Fn);
+        Loaders.push_back({Fn, nullptr, nullptr, {}, {}, {}});
     }
 
     // Add function object to this composite loader.
     template <typename T, typename... Args>
     void add(Args&&... A)
     {
-        Loaders.push_back(T{std::forward<Args>(A)...});
+        Loaders.push_back({T{std::forward<Args>(A)...}, nullptr, nullptr, {}, {}, {}});
+    }
+
+    // Add a loader that computes its facts in C++ containers before inserting
+    // them, such as InstructionLoader. T::prepare(Module, Program) reads the
+    // program and the AuxData of the module; T::facts(Module) then only reads
+    // the module and returns an Inserter. Consecutive such loaders compute
+    // their facts concurrently, unless one of them reads a relation that
+    // another one populates: the Consumes relations, which are only read if
+    // ConsumesOption is empty or set.
+    template <typename T>
+    void addConcurrent(T Object, const std::vector<std::string>& Produces,
+                       const std::vector<std::string>& Consumes = {},
+                       const std::string& ConsumesOption = "")
+    {
+        auto Shared = std::make_shared<T>(std::move(Object));
+        auto Prepare = [Shared](const gtirb::Module& M, souffle::SouffleProgram& P) {
+            Shared->prepare(M, P);
+        };
+        auto Facts = [Shared](const gtirb::Module& M) { return Shared->facts(M); };
+        Loaders.push_back({nullptr, Prepare, Facts, Produces, Consumes, ConsumesOption});
+    }
+
+    // Name of the Souffle program populated by this loader.
+    const std::string& getName() const
+    {
+        return Name;
+    }
+
+    // Add an option to the "option" relation before any loader runs.
+    void addOption(const std::string& Option)
+    {
+        Options.push_back(Option);
     }
 
-    // Build a SouffleProgram
-    std::unique_ptr<souffle::SouffleProgram> load(const gtirb::Module& Module)
+    // Build a SouffleProgram, reusing one from the ProgramPool if possible.
+    std::unique_ptr<souffle::SouffleProgram> load(const gtirb::Module& Module,
+                                                  const Executor& Exec = Executor::sequential())
     {
-        std::unique_ptr<souffle::SouffleProgram> Program(
-            souffle::ProgramFactory::newInstance(Name));
+        std::unique_ptr<souffle::SouffleProgram> Program = ProgramPool::instance().acquire(Name);
         if(Program)
         {
-            operator()(Module, *Program);
+            run(Module, *Program, Exec);
         }
         return Program;
     }
@@ -68,15 +107,30 @@ public:
     // Implement loader interface for composition of CompositeLoaders.
     void operator()(const gtirb::Module& Module, souffle::SouffleProgram& Program)
     {
-        for(auto& Loader : Loaders)
-        {
-            Loader(Module, Program);
-        }
+        run(Module, Program, Executor::sequential());
     }
 
+    // Run the loaders in the order they were added. The facts of consecutive
+    // concurrent loaders are computed on Exec and inserted in order.
+    void run(const gtirb::Module& Module, souffle::SouffleProgram& Program, const Executor& Exec);
+
 private:
+    struct Entry
+    {
+        Loader Fn;
+        std::function<void(const gtirb::Module&, souffle::SouffleProgram&)> Prepare;
+        std::function<Inserter(const gtirb::Module&)> Facts;
+        std::vector<std::string> Produces;
+        std::vector<std::string> Consumes;
+        std::string ConsumesOption;
+    };
+
+    void runGroup(const std::vector<const Entry*>& Group, const gtirb::Module& Module,
+                  souffle::SouffleProgram& Program, const Executor& Exec);
+
     std::string Name;
-    std::vector<Loader> Loaders;
+    std::vector<Entry> Loaders;
+    std::vector<std::string> Options;
 };
 
 #endif // SRC_GTIRB_DECODER_COMPOSITELOADER_H_
@@ -0,0 +1,81 @@
+//===- Executor.cpp ---------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the GNU Affero General Public License
+//  as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version. See the
+//  LICENSE.txt file in the project root for license terms or visit
+//  https://www.gnu.org/licenses/agpl.txt.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU Affero General Public License for more details.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//===----------------------------------------------------------------------===//
+#include "Executor.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+void Executor::parallelFor(size_t Count, const std::function<void(size_t)>& Fn) const
+{
+#if defined(_OPENMP)
+    size_t Threads = std::min<size_t>(ThreadCount, Count);
+    // Nested regions would multiply the number of threads.
+    if(Threads > 1 && !omp_in_parallel())
+    {
+        std::exception_ptr Error;
+        std::mutex ErrorMutex;
+        int64_t End = static_cast<int64_t>(Count);
+#pragma omp parallel for num_threads(static_cast<int>(Threads)) schedule(dynamic)
+        for(int64_t I = 0; I < End; I++)
+        {
+            try
+            {
+                Fn(static_cast<size_t>(I));
+            }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> Lock(ErrorMutex);
+                if(!Error)
+                {
+                    Error = std::current_exception();
+                }
+            }
+        }
+        if(Error)
+        {
+            std::rethrow_exception(Error);
+        }
+        return;
+    }
+#endif
+    for(size_t I = 0; I < Count; I++)
+    {
+        Fn(I);
+    }
+}
+
+void Executor::run(const std::vector<std::function<void()>>& Tasks) const
+{
+    parallelFor(Tasks.size(), [&](size_t I) { Tasks[I](); });
+}
+
+const Executor& Executor::sequential()
+{
+    static const Executor Sequential;
+    return Sequential;
+}
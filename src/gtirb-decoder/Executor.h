@@ -0,0 +1,77 @@
+//===- Executor.h -----------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the GNU Affero General Public License
+//  as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version. See the
+//  LICENSE.txt file in the project root for license terms or visit
+//  https://www.gnu.org/licenses/agpl.txt.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU Affero General Public License for more details.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//===----------------------------------------------------------------------===//
+#ifndef _EXECUTOR_H_
+#define _EXECUTOR_H_
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+/**
+Pipeline-wide executor for the C++ stages of the analysis.
+
+Tasks run on the OpenMP runtime that Souffle uses for the Datalog stages, so
+both kinds of stages draw from the same set of worker threads and never exceed
+the configured thread count. Work is handed out dynamically, so long tasks do
+not hold up idle threads.
+*/
+class Executor
+{
+public:
+    explicit Executor(unsigned int ThreadCount_ = 1) : ThreadCount(ThreadCount_ ? ThreadCount_ : 1)
+    {
+    }
+
+    unsigned int getThreadCount() const
+    {
+        return ThreadCount;
+    }
+
+    void setThreadCount(unsigned int Count)
+    {
+        ThreadCount = Count ? Count : 1;
+    }
+
+    /**
+    Call Fn for every index in [0, Count) and wait for all calls to finish.
+
+    Calls issued from a task that is already running on the executor are
+    performed sequentially. If any call throws, the first exception is rethrown
+    once all calls have finished.
+    */
+    void parallelFor(size_t Count, const std::function<void(size_t)>& Fn) const;
+
+    /**
+    Run independent tasks and wait for all of them to finish.
+    */
+    void run(const std::vector<std::function<void()>>& Tasks) const;
+
+    /**
+    Executor that runs everything on the calling thread.
+    */
+    static const Executor& sequential();
+
+private:
+    unsigned int ThreadCount;
+};
+
+#endif // _EXECUTOR_H_
@@ -0,0 +1,100 @@
+//===- ProgramPool.cpp ------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the GNU Affero General Public License
+//  as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version. See the
+//  LICENSE.txt file in the project root for license terms or visit
+//  https://www.gnu.org/licenses/agpl.txt.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU Affero General Public License for more details.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include "ProgramPool.h"
+
+ProgramPool& ProgramPool::instance()
+{
+    static ProgramPool Pool;
+    return Pool;
+}
+
+std::unique_ptr<souffle::SouffleProgram> ProgramPool::acquire(const std::string& Name)
+{
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        if(auto Type = Types.find(Name); Type != Types.end())
+        {
+            auto& Programs = Free[Type->second];
+            if(!Programs.empty())
+            {
+                std::unique_ptr<souffle::SouffleProgram> Program = std::move(Programs.back());
+                Programs.pop_back();
+                return Program;
+            }
+        }
+    }
+
+    std::unique_ptr<souffle::SouffleProgram> Program(souffle::ProgramFactory::newInstance(Name));
+    if(Program)
+    {
+        souffle::SouffleProgram& Instance = *Program;
+        std::lock_guard<std::mutex> Lock(Mutex);
+        Types.emplace(Name, std::type_index(typeid(Instance)));
+    }
+    return Program;
+}
+
+void ProgramPool::release(std::unique_ptr<souffle::SouffleProgram> Program)
+{
+    if(!Program)
+    {
+        return;
+    }
+    souffle::SouffleProgram& Instance = *Program;
+    std::type_index Type(typeid(Instance));
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        if(Free[Type].size() >= Capacity)
+        {
+            return;
+        }
+    }
+
+    // Purge outside the lock: large relations take a while to free.
+    for(souffle::Relation* Relation : Instance.getAllRelations())
+    {
+        Relation->purge();
+    }
+
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Free[Type].push_back(std::move(Program));
+}
+
+void ProgramPool::setCapacity(size_t Count)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Capacity = Count;
+    for(auto& [Type, Programs] : Free)
+    {
+        if(Programs.size() > Capacity)
+        {
+            Programs.resize(Capacity);
+        }
+    }
+}
+
+void ProgramPool::clear()
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Free.clear();
+}
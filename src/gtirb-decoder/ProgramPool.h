@@ -0,0 +1,81 @@
+//===- ProgramPool.h --------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the GNU Affero General Public License
+//  as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version. See the
+//  LICENSE.txt file in the project root for license terms or visit
+//  https://www.gnu.org/licenses/agpl.txt.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU Affero General Public License for more details.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#ifndef _PROGRAM_POOL_H_
+#define _PROGRAM_POOL_H_
+
+#include <souffle/SouffleInterface.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <vector>
+
+/**
+Process-wide pool of Souffle programs, reused across modules and passes.
+
+A program is released to the pool when its pass is cleared. Its relations are
+purged, and the next acquire of the same program returns it instead of
+constructing the hundreds of relations and indexes of a new instance.
+
+Souffle cannot reset the symbol table of a program, so the symbols of the
+previous modules are kept; most of them (e.g. register and mnemonic names)
+are interned again by the next module anyway. The ordinals of the symbols, and
+thus the order of the tuples that contain them, depend on the previous modules.
+The pool therefore holds no programs until setCapacity raises its capacity,
+which ddisasm only does with --reuse-programs.
+*/
+class ProgramPool
+{
+public:
+    static ProgramPool& instance();
+
+    /**
+    Get a program with empty relations, or nullptr if no program Name is
+    registered with the souffle::ProgramFactory.
+    */
+    std::unique_ptr<souffle::SouffleProgram> acquire(const std::string& Name);
+
+    /**
+    Purge the relations of Program and keep it for the next acquire, unless
+    the pool already holds Capacity programs of its kind.
+    */
+    void release(std::unique_ptr<souffle::SouffleProgram> Program);
+
+    void setCapacity(size_t Count);
+
+    // Programs of each kind kept with --reuse-programs.
+    static constexpr size_t ReuseCapacity = 8;
+
+    // Destroy the programs held by the pool.
+    void clear();
+
+private:
+    std::mutex Mutex;
+    size_t Capacity = 0;
+    std::map<std::string, std::type_index> Types;
+    std::map<std::type_index, std::vector<std::unique_ptr<souffle::SouffleProgram>>> Free;
+};
+
+#endif // _PROGRAM_POOL_H_
@@ -22,6 +22,17 @@
 //===----------------------------------------------------------------------===//
 #include "Relations.h"
 
+bool relations::hasOption(souffle::SouffleProgram& Program, const std::string& Option)
+{
+    if(auto* Relation = Program.getRelation("option"))
+    {
+        souffle::tuple Row(Relation);
+        Row << Option;
+        return Relation->contains(Row);
+    }
+    return false;
+}
+
 namespace souffle
 {
     souffle::tuple& operator<<(souffle::tuple& T, const gtirb::Addr& A)
@@ -232,4 +243,10 @@ namespace souffle
         return T;
     }
 
+    souffle::tuple& operator<<(souffle::tuple& T, const relations::AnalysisBudget& Budget)
+    {
+        T << Budget.Name << Budget.Limit;
+        return T;
+    }
+
 } // namespace souffle
@@ -37,6 +37,9 @@
 
 namespace relations
 {
+    // Check whether Option is in the "option" relation of the Datalog program.
+    bool hasOption(souffle::SouffleProgram& Program, const std::string& Option);
+
     template <typename T>
     void insert(souffle::SouffleProgram& Program, const std::string& Name, const T& Data)
     {
@@ -299,6 +302,12 @@ namespace relations
         uint64_t Count;
     };
 
+    struct AnalysisBudget
+    {
+        std::string Name;
+        uint64_t Limit;
+    };
+
 } // namespace relations
 
 namespace souffle
@@ -382,6 +391,8 @@ namespace souffle
 
     souffle::tuple& operator<<(souffle::tuple& T, const relations::RepeatedByte& RepeatedByte);
 
+    souffle::tuple& operator<<(souffle::tuple& T, const relations::AnalysisBudget& Budget);
+
 } // namespace souffle
 
 #endif // SRC_GTIRB_DECODER_RELATIONS_H_
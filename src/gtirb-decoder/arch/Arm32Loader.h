@@ -42,14 +42,14 @@ public:
         cs_option(*CsHandle, CS_OPT_DETAIL, CS_OPT_ON);
     }
 
-protected:
-    // override from CodeBlockLoader
-    void load(const gtirb::Module& Module, BinaryFacts& Facts) override
+    // The Capstone modes depend on the ArchInfo AuxData.
+    void prepare(const gtirb::Module& Module, souffle::SouffleProgram& Program) override
     {
+        InstructionLoader::prepare(Module, Program);
         initCsModes(Module);
-        InstructionLoader::load(Module, Facts);
     }
 
+protected:
     void load(const gtirb::Module& Module, const gtirb::ByteInterval& ByteInterval,
               BinaryFacts& Facts) override;
     void load(const gtirb::ByteInterval& ByteInterval, BinaryFacts& Facts, size_t ExecutionMode,
@@ -28,18 +28,29 @@
 
 void DataLoader::operator()(const gtirb::Module& Module, souffle::SouffleProgram& Program)
 {
-    DataFacts Facts;
-    load(Module, Facts);
-
-    relations::insert(Program, "address_in_data", std::move(Facts.Addresses));
-    relations::insert(Program, "ascii_string", std::move(Facts.Ascii));
-    relations::insert(Program, "repeated_byte", std::move(Facts.RepeatedByte));
+    prepare(Module, Program);
+    facts(Module)(Program);
 }
 
-void DataLoader::load(const gtirb::Module& Module, DataFacts& Facts)
+void DataLoader::prepare(const gtirb::Module& Module, souffle::SouffleProgram&)
 {
     FunctorContext.useModule(&Module);
+}
+
+std::function<void(souffle::SouffleProgram&)> DataLoader::facts(const gtirb::Module& Module)
+{
+    auto Facts = std::make_shared<DataFacts>();
+    load(Module, *Facts);
+
+    return [Facts](souffle::SouffleProgram& Program) {
+        relations::insert(Program, "address_in_data", std::move(Facts->Addresses));
+        relations::insert(Program, "ascii_string", std::move(Facts->Ascii));
+        relations::insert(Program, "repeated_byte", std::move(Facts->RepeatedByte));
+    };
+}
 
+void DataLoader::load(const gtirb::Module& Module, DataFacts& Facts)
+{
     std::optional<gtirb::Addr> Min, Max;
     for(const auto& Section : Module.sections())
     {
@@ -23,7 +23,9 @@
 #ifndef SRC_GTIRB_DECODER_CORE_DATALOADER_H_
 #define SRC_GTIRB_DECODER_CORE_DATALOADER_H_
 
+#include <functional>
 #include <gtirb/gtirb.hpp>
+#include <string>
 #include <vector>
 
 #include "../Relations.h"
@@ -56,6 +58,13 @@ public:
 
     virtual void operator()(const gtirb::Module& Module, souffle::SouffleProgram& Program);
 
+    // Select the module of the Datalog functors.
+    void prepare(const gtirb::Module& Module, souffle::SouffleProgram& Program);
+
+    // Scan the data sections, which may run concurrently with other loaders,
+    // and return the function that inserts the facts.
+    std::function<void(souffle::SouffleProgram&)> facts(const gtirb::Module& Module);
+
 protected:
     virtual void load(const gtirb::Module& Module, DataFacts& Facts);
     virtual void load(const gtirb::ByteInterval& Bytes, DataFacts& Facts);
@@ -65,4 +74,8 @@ private:
     Endian Endianness;
 };
 
+// Relations populated by DataLoader.
+inline const std::vector<std::string> DataLoaderRelations = {"address_in_data", "ascii_string",
+                                                             "repeated_byte"};
+
 #endif // SRC_GTIRB_DECODER_CORE_DATALOADER_H_
@@ -80,6 +80,102 @@ void InstructionLoader::insert(const BinaryFacts& Facts, souffle::SouffleProgram
     relations::insert(Program, "op_register_bitfield", Operands.reg_bitfields());
 }
 
+/**
+Collect function ranges with known instruction boundaries: sized FUNC symbols
+and, if `ElfExceptionLoader` has already populated `fde_entry`, FDE ranges.
+Nested and overlapping ranges are merged, so that pruning covers all of an
+outer range; their start addresses are kept as points the sweep must visit.
+*/
+void InstructionLoader::loadKnownCode(const gtirb::Module& Module,
+                                      souffle::SouffleProgram& Program)
+{
+    std::vector<std::pair<uint64_t, uint64_t>> Ranges;
+
+    if(auto* SymbolInfo = Module.getAuxData<gtirb::schema::ElfSymbolInfo>())
+    {
+        for(const auto& Symbol : Module.symbols())
+        {
+            auto Found = SymbolInfo->find(Symbol.getUUID());
+            if(!Symbol.getAddress() || Found == SymbolInfo->end())
+            {
+                continue;
+            }
+            uint64_t Size = std::get<0>(Found->second);
+            const std::string& Type = std::get<1>(Found->second);
+            if(Type == "FUNC" && Size > 0)
+            {
+                uint64_t Begin = static_cast<uint64_t>(*Symbol.getAddress());
+                Ranges.emplace_back(Begin, Begin + Size);
+            }
+        }
+    }
+
+    if(auto* Relation = Program.getRelation("fde_entry"))
+    {
+        for(auto& Row : *Relation)
+        {
+            uint64_t FdeAddr, Length, Cie, Begin, End;
+            Row >> FdeAddr >> Length >> Cie >> Begin >> End;
+            if(Begin < End)
+            {
+                Ranges.emplace_back(Begin, End);
+            }
+        }
+    }
+
+    std::sort(Ranges.begin(), Ranges.end());
+    for(const auto& [Begin, End] : Ranges)
+    {
+        KnownEntries.insert(Begin);
+        if(!KnownCode.empty() && Begin <= std::prev(KnownCode.end())->second)
+        {
+            uint64_t& Last = std::prev(KnownCode.end())->second;
+            Last = std::max(Last, End);
+        }
+        else
+        {
+            KnownCode.emplace_hint(KnownCode.end(), Begin, End);
+        }
+    }
+}
+
+uint64_t InstructionLoader::nextOffset(const BinaryFacts& Facts, uint64_t Addr) const
+{
+    if(KnownCode.empty())
+    {
+        return MinInstructionSize;
+    }
+
+    // Find the last range starting at or before Addr.
+    auto Next = KnownCode.upper_bound(Addr);
+    if(Next == KnownCode.begin())
+    {
+        return MinInstructionSize;
+    }
+    auto Range = std::prev(Next);
+    if(Addr >= Range->second)
+    {
+        return MinInstructionSize;
+    }
+
+    // Decoding failed inside the range: fall back to the superset.
+    const auto& Instructions = Facts.Instructions.instructions();
+    if(Instructions.empty() || Instructions.back().Addr != gtirb::Addr(Addr))
+    {
+        return MinInstructionSize;
+    }
+
+    // Step over the instruction, but do not skip the start of the next
+    // range, nor that of a function nested in this one.
+    uint64_t Step = Instructions.back().Size;
+    if(auto Entry = KnownEntries.upper_bound(Addr);
+       Entry != KnownEntries.end() && *Entry < Addr + Step)
+    {
+        Step = *Entry - Addr;
+    }
+    return Step;
+}
+
 /**
 Load register access facts
 */
@@ -25,7 +25,13 @@
 #include <capstone/capstone.h>
 #include <souffle/SouffleInterface.h>
 
+#include <algorithm>
+#include <functional>
 #include <gtirb/gtirb.hpp>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
 #include <vector>
 
 #include "../Relations.h"
@@ -226,9 +232,28 @@ public:
 
     void operator()(const gtirb::Module& Module, souffle::SouffleProgram& Program)
     {
-        BinaryFacts Facts;
-        load(Module, Facts);
-        insert(Facts, Program);
+        prepare(Module, Program);
+        facts(Module)(Program);
+    }
+
+    // Read the options, the inputs and the AuxData tables the decoding needs.
+    virtual void prepare(const gtirb::Module& Module, souffle::SouffleProgram& Program)
+    {
+        KnownCode.clear();
+        KnownEntries.clear();
+        if(relations::hasOption(Program, "prune-superset"))
+        {
+            loadKnownCode(Module, Program);
+        }
+    }
+
+    // Decode the module, which only reads its bytes and may run concurrently
+    // with other loaders, and return the function that inserts the facts.
+    std::function<void(souffle::SouffleProgram&)> facts(const gtirb::Module& Module)
+    {
+        auto Facts = std::make_shared<BinaryFacts>();
+        load(Module, *Facts);
+        return [this, Facts](souffle::SouffleProgram& Program) { insert(*Facts, Program); };
     }
 
 protected:
@@ -272,12 +297,20 @@ protected:
         while(Size > 0)
         {
             decode(Facts, Data, Size, Addr);
-            Addr += MinInstructionSize;
-            Data += MinInstructionSize;
-            Size -= MinInstructionSize;
+            uint64_t Step = std::min(nextOffset(Facts, Addr), Size);
+            Addr += Step;
+            Data += Step;
+            Size -= Step;
         }
     }
 
+    // Collect the ranges of code with known instruction boundaries.
+    virtual void loadKnownCode(const gtirb::Module& Module, souffle::SouffleProgram& Program);
+
+    // Number of bytes to advance after decoding at Addr: the size of the
+    // decoded instruction inside known code, MinInstructionSize otherwise.
+    uint64_t nextOffset(const BinaryFacts& Facts, uint64_t Addr) const;
+
     // Load register accesses for a cs_insn
     virtual void loadRegisterAccesses(BinaryFacts& Facts, uint64_t Addr,
                                       const cs_insn& CsInstruction);
@@ -291,9 +324,25 @@ protected:
     // We default to decoding instructions at every byte offset.
     uint8_t MinInstructionSize = 1;
 
+    // Disjoint function ranges [Begin,End) indexed by Begin, inside of which
+    // only the linear-sweep offsets are decoded (enabled by the
+    // "prune-superset" option), and the start addresses of all the functions.
+    std::map<uint64_t, uint64_t> KnownCode;
+    std::set<uint64_t> KnownEntries;
+
     std::shared_ptr<csh> CsHandle;
 };
 
+// Relations populated by InstructionLoader.
+inline const std::vector<std::string> InstructionLoaderRelations = {
+    "instruction",     "instruction_writeback", "instruction_cond_code", "instruction_op_access",
+    "invalid_op_code", "op_shifted",            "op_shifted_w_reg",      "register_access",
+    "op_immediate",    "op_regdirect",          "op_fp_immediate",       "op_indirect",
+    "op_special",      "op_register_bitfield"};
+
+// Relations read by InstructionLoader with the "prune-superset" option.
+inline const std::vector<std::string> InstructionLoaderInputs = {"fde_entry"};
+
 // Decorator for loading instructions from known code blocks.
 template <typename T>
 class CodeBlockLoader : public T
@@ -62,11 +62,28 @@ void ModuleLoader(const gtirb::Module& Module, souffle::SouffleProgram& Program)
         BinaryType = "EXEC";
     }
 
+    // Binary features used to skip optional analyses.
+    std::vector<std::string> Features;
+    for(const auto& Section : Module.sections())
+    {
+        if(Section.isFlagSet(gtirb::SectionFlag::ThreadLocal))
+        {
+            Features.push_back("tls");
+            break;
+        }
+    }
+    if(auto* Relocations = Module.getAuxData<gtirb::schema::Relocations>();
+       Relocations && !Relocations->empty())
+    {
+        Features.push_back("relocations");
+    }
+
     relations::insert<std::vector<std::string>>(Program, "binary_type", {BinaryType});
     relations::insert<std::vector<std::string>>(Program, "binary_format", {BinaryFormat});
     relations::insert<std::vector<gtirb::Addr>>(Program, "base_address", {BaseAddress});
     relations::insert<std::vector<gtirb::Addr>>(Program, "entry_point", {EntryPoint});
     relations::insert<std::vector<std::string>>(Program, "endianness", {Endianness});
+    relations::insert(Program, "binary_feature", Features);
 }
 
 const char* binaryFormat(const gtirb::FileFormat Format)
@@ -35,8 +35,9 @@ CompositeLoader ElfArm32Loader()
     CompositeLoader Loader("souffle_disasm_arm32");
     Loader.add(ModuleLoader);
     Loader.add(SectionLoader);
-    Loader.add<Arm32Loader>();
-    Loader.add<DataLoader>(DataLoader::Pointer::DWORD);
+    Loader.addConcurrent(Arm32Loader(), InstructionLoaderRelations, InstructionLoaderInputs,
+                         "prune-superset");
+    Loader.addConcurrent(DataLoader(DataLoader::Pointer::DWORD), DataLoaderRelations);
     Loader.add(ElfDynamicEntryLoader);
     Loader.add(ElfSymbolLoader);
     Loader.add(ElfExceptionLoader);
@@ -35,8 +35,9 @@ CompositeLoader ElfArm64Loader()
     CompositeLoader Loader("souffle_disasm_arm64");
     Loader.add(ModuleLoader);
     Loader.add(SectionLoader);
-    Loader.add<Arm64Loader>();
-    Loader.add<DataLoader>(DataLoader::Pointer::QWORD);
+    Loader.addConcurrent(Arm64Loader(), InstructionLoaderRelations, InstructionLoaderInputs,
+                         "prune-superset");
+    Loader.addConcurrent(DataLoader(DataLoader::Pointer::QWORD), DataLoaderRelations);
     Loader.add(ElfDynamicEntryLoader);
     Loader.add(ElfSymbolLoader);
     Loader.add(ElfExceptionLoader);
@@ -35,8 +35,10 @@ CompositeLoader ElfMips32BELoader()
     CompositeLoader Loader("souffle_disasm_mips32");
     Loader.add(ModuleLoader);
     Loader.add(SectionLoader);
-    Loader.add<Mips32Loader>(Mips32Loader::Endian::BIG);
-    Loader.add<DataLoader>(DataLoader::Pointer::DWORD, DataLoader::Endian::BIG);
+    Loader.addConcurrent(Mips32Loader(Mips32Loader::Endian::BIG), InstructionLoaderRelations,
+                         InstructionLoaderInputs, "prune-superset");
+    Loader.addConcurrent(DataLoader(DataLoader::Pointer::DWORD, DataLoader::Endian::BIG),
+                         DataLoaderRelations);
     Loader.add(ElfDynamicEntryLoader);
     Loader.add(ElfSymbolLoader);
     Loader.add(ElfExceptionLoader);
@@ -48,8 +50,10 @@ CompositeLoader ElfMips32LELoader()
     CompositeLoader Loader("souffle_disasm_mips32");
     Loader.add(ModuleLoader);
     Loader.add(SectionLoader);
-    Loader.add<Mips32Loader>(Mips32Loader::Endian::LITTLE);
-    Loader.add<DataLoader>(DataLoader::Pointer::DWORD, DataLoader::Endian::LITTLE);
+    Loader.addConcurrent(Mips32Loader(Mips32Loader::Endian::LITTLE), InstructionLoaderRelations,
+                         InstructionLoaderInputs, "prune-superset");
+    Loader.addConcurrent(DataLoader(DataLoader::Pointer::DWORD, DataLoader::Endian::LITTLE),
+                         DataLoaderRelations);
     Loader.add(ElfDynamicEntryLoader);
     Loader.add(ElfSymbolLoader);
     Loader.add(ElfExceptionLoader);
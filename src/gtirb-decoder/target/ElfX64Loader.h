@@ -35,11 +35,13 @@ CompositeLoader ElfX64Loader()
     CompositeLoader Loader("souffle_disasm_x86_64");
     Loader.add(ModuleLoader);
     Loader.add(SectionLoader);
-    Loader.add<X64Loader>();
-    Loader.add<DataLoader>(DataLoader::Pointer::QWORD);
+    // Load FDEs first: they seed the known code ranges of the instruction loader.
+    Loader.add(ElfExceptionLoader);
+    Loader.addConcurrent(X64Loader(), InstructionLoaderRelations, InstructionLoaderInputs,
+                         "prune-superset");
+    Loader.addConcurrent(DataLoader(DataLoader::Pointer::QWORD), DataLoaderRelations);
     Loader.add(ElfDynamicEntryLoader);
     Loader.add(ElfSymbolLoader);
-    Loader.add(ElfExceptionLoader);
     return Loader;
 }
 
@@ -35,10 +35,12 @@ CompositeLoader ElfX86Loader()
     CompositeLoader Loader("souffle_disasm_x86_32");
     Loader.add(ModuleLoader);
     Loader.add(SectionLoader);
-    Loader.add<X86Loader>();
-    Loader.add<DataLoader>(DataLoader::Pointer::DWORD);
-    Loader.add(ElfSymbolLoader);
+    // Load FDEs first: they seed the known code ranges of the instruction loader.
     Loader.add(ElfExceptionLoader);
+    Loader.addConcurrent(X86Loader(), InstructionLoaderRelations, InstructionLoaderInputs,
+                         "prune-superset");
+    Loader.addConcurrent(DataLoader(DataLoader::Pointer::DWORD), DataLoaderRelations);
+    Loader.add(ElfSymbolLoader);
     return Loader;
 }
 
@@ -35,8 +35,9 @@ CompositeLoader PeX64Loader()
     CompositeLoader Loader("souffle_disasm_x86_64");
     Loader.add(ModuleLoader);
     Loader.add(SectionLoader);
-    Loader.add<X64Loader>();
-    Loader.add<DataLoader>(DataLoader::Pointer::QWORD);
+    Loader.addConcurrent(X64Loader(), InstructionLoaderRelations, InstructionLoaderInputs,
+                         "prune-superset");
+    Loader.addConcurrent(DataLoader(DataLoader::Pointer::QWORD), DataLoaderRelations);
     Loader.add(PeSymbolLoader);
     Loader.add(PeDataDirectoryLoader);
     return Loader;
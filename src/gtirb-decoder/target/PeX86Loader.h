@@ -35,8 +35,9 @@ CompositeLoader PeX86Loader()
     CompositeLoader Loader("souffle_disasm_x86_32");
     Loader.add(ModuleLoader);
     Loader.add(SectionLoader);
-    Loader.add<X86Loader>();
-    Loader.add<DataLoader>(DataLoader::Pointer::DWORD);
+    Loader.addConcurrent(X86Loader(), InstructionLoaderRelations, InstructionLoaderInputs,
+                         "prune-superset");
+    Loader.addConcurrent(DataLoader(DataLoader::Pointer::DWORD), DataLoaderRelations);
     Loader.add(PeSymbolLoader);
     Loader.add(PeDataDirectoryLoader);
     return Loader;
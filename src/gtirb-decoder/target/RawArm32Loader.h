@@ -32,8 +32,9 @@ CompositeLoader RawArm32Loader()
     CompositeLoader Loader("souffle_disasm_arm32");
     Loader.add(ModuleLoader);
     Loader.add(SectionLoader);
-    Loader.add<Arm32Loader>();
-    Loader.add<DataLoader>(DataLoader::Pointer::DWORD);
+    Loader.addConcurrent(Arm32Loader(), InstructionLoaderRelations, InstructionLoaderInputs,
+                         "prune-superset");
+    Loader.addConcurrent(DataLoader(DataLoader::Pointer::DWORD), DataLoaderRelations);
     Loader.add(RawEntryLoader);
     return Loader;
 }
@@ -32,8 +32,9 @@ CompositeLoader RawArm64Loader()
     CompositeLoader Loader("souffle_disasm_arm64");
     Loader.add(ModuleLoader);
     Loader.add(SectionLoader);
-    Loader.add<Arm64Loader>();
-    Loader.add<DataLoader>(DataLoader::Pointer::QWORD);
+    Loader.addConcurrent(Arm64Loader(), InstructionLoaderRelations, InstructionLoaderInputs,
+                         "prune-superset");
+    Loader.addConcurrent(DataLoader(DataLoader::Pointer::QWORD), DataLoaderRelations);
     Loader.add(RawEntryLoader);
     return Loader;
 }
@@ -32,8 +32,10 @@ CompositeLoader RawMips32BELoader()
     CompositeLoader Loader("souffle_disasm_mips32");
     Loader.add(ModuleLoader);
     Loader.add(SectionLoader);
-    Loader.add<Mips32Loader>(Mips32Loader::Endian::BIG);
-    Loader.add<DataLoader>(DataLoader::Pointer::DWORD, DataLoader::Endian::BIG);
+    Loader.addConcurrent(Mips32Loader(Mips32Loader::Endian::BIG), InstructionLoaderRelations,
+                         InstructionLoaderInputs, "prune-superset");
+    Loader.addConcurrent(DataLoader(DataLoader::Pointer::DWORD, DataLoader::Endian::BIG),
+                         DataLoaderRelations);
     Loader.add(RawEntryLoader);
     return Loader;
 }
@@ -43,8 +45,10 @@ CompositeLoader RawMips32LELoader()
     CompositeLoader Loader("souffle_disasm_mips32");
     Loader.add(ModuleLoader);
     Loader.add(SectionLoader);
-    Loader.add<Mips32Loader>(Mips32Loader::Endian::LITTLE);
-    Loader.add<DataLoader>(DataLoader::Pointer::DWORD, DataLoader::Endian::LITTLE);
+    Loader.addConcurrent(Mips32Loader(Mips32Loader::Endian::LITTLE), InstructionLoaderRelations,
+                         InstructionLoaderInputs, "prune-superset");
+    Loader.addConcurrent(DataLoader(DataLoader::Pointer::DWORD, DataLoader::Endian::LITTLE),
+                         DataLoaderRelations);
     Loader.add(RawEntryLoader);
     return Loader;
 }
@@ -32,8 +32,9 @@ CompositeLoader RawX64Loader()
     CompositeLoader Loader("souffle_disasm_x86_64");
     Loader.add(ModuleLoader);
     Loader.add(SectionLoader);
-    Loader.add<X64Loader>();
-    Loader.add<DataLoader>(DataLoader::Pointer::QWORD);
+    Loader.addConcurrent(X64Loader(), InstructionLoaderRelations, InstructionLoaderInputs,
+                         "prune-superset");
+    Loader.addConcurrent(DataLoader(DataLoader::Pointer::QWORD), DataLoaderRelations);
     Loader.add(RawEntryLoader);
     return Loader;
 }
@@ -27,7 +27,12 @@
 #include <chrono>
 #include <gtirb/gtirb.hpp>
 #include <list>
+#include <optional>
 #include <string>
+#include <utility>
+#include <vector>
+
+#include "../gtirb-decoder/Executor.h"
 
 namespace fs = boost::filesystem;
 
@@ -36,6 +41,11 @@ struct AnalysisPassResult
     std::list<std::string> Warnings;
     std::list<std::string> Errors;
     std::chrono::duration<double> RunTime;
+    // Peak resident set size in bytes, if the pipeline monitors the memory.
+    uint64_t PeakMemory = 0;
+    // Tuples of the largest relations of a Datalog pass at the end of the
+    // phase, if the pipeline records them.
+    std::vector<std::pair<std::string, size_t>> LargestRelations;
 };
 
 /**
@@ -86,11 +96,38 @@ public:
         MultiModule = MultiModule_;
     }
 
+    /**
+    Use the pipeline's executor for the parallel parts of the pass.
+    */
+    void setExecutor(const Executor* Exec_)
+    {
+        Exec = Exec_;
+    }
+
     /**
     Prepare for running the pass on an additional Module with the same settings.
     */
     virtual void clear();
 
+    /**
+    Switch to cheaper settings for the next runs, when memory or time runs short.
+    Return the name of the step (e.g. "prune-superset"), or nothing if there
+    are no cheaper settings.
+    */
+    virtual std::optional<std::string> reduceCost()
+    {
+        return std::nullopt;
+    }
+
+    /**
+    Optional passes only refine the results of the previous passes, and are
+    skipped when the pipeline runs out of time.
+    */
+    virtual bool isOptional() const
+    {
+        return false;
+    }
+
 protected:
     virtual void loadImpl(AnalysisPassResult& Result, const gtirb::Context& Context,
                           const gtirb::Module& Module, AnalysisPass* PreviousPass = nullptr) = 0;
@@ -99,6 +136,12 @@ protected:
                                gtirb::Module& Module) = 0;
     std::string DebugDirRoot;
     bool MultiModule = false;
+    const Executor* Exec = nullptr;
+
+    const Executor& getExecutor() const
+    {
+        return Exec ? *Exec : Executor::sequential();
+    }
 
     std::string getDebugDir(const gtirb::Module& Module)
     {
@@ -0,0 +1,49 @@
+//===- CfgPatch.cpp ---------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the GNU Affero General Public License
+//  as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version. See the
+//  LICENSE.txt file in the project root for license terms or visit
+//  https://www.gnu.org/licenses/agpl.txt.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU Affero General Public License for more details.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include "CfgPatch.h"
+
+#include <boost/graph/adjacency_list.hpp>
+
+void CfgPatch::apply(gtirb::CFG& Cfg) const
+{
+    for(const auto& [Src, Type] : Removals)
+    {
+        if(std::optional<gtirb::CFG::vertex_descriptor> Vertex = gtirb::getVertex(Src, Cfg))
+        {
+            boost::remove_out_edge_if(
+                *Vertex,
+                [&Cfg, Type = Type](const gtirb::CFG::edge_descriptor& Edge) {
+                    const gtirb::EdgeLabel& Label = Cfg[Edge];
+                    return Label && std::get<gtirb::EdgeType>(*Label) == Type;
+                },
+                Cfg);
+        }
+    }
+    for(const Insertion& Edge : Insertions)
+    {
+        if(auto E = gtirb::addEdge(Edge.Src, Edge.Dest, Cfg))
+        {
+            Cfg[*E] = Edge.Label;
+        }
+    }
+}
@@ -0,0 +1,77 @@
+//===- CfgPatch.h -----------------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the GNU Affero General Public License
+//  as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version. See the
+//  LICENSE.txt file in the project root for license terms or visit
+//  https://www.gnu.org/licenses/agpl.txt.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU Affero General Public License for more details.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#ifndef CFG_PATCH_H_
+#define CFG_PATCH_H_
+
+#include <gtirb/gtirb.hpp>
+#include <vector>
+
+/**
+Batch of CFG edge removals and insertions, applied in a single step.
+
+Removals are restricted to the out-edges of the given source nodes, so
+applying a patch only visits the edges of the nodes it touches.
+*/
+class CfgPatch
+{
+public:
+    /**
+    Remove the out-edges of Src that have the given edge type.
+    */
+    void removeOutEdges(const gtirb::CfgNode* Src, gtirb::EdgeType Type)
+    {
+        Removals.emplace_back(Src, Type);
+    }
+
+    /**
+    Add an edge from Src to Dest with the given label.
+    */
+    void addEdge(const gtirb::CfgNode* Src, const gtirb::CfgNode* Dest,
+                 const gtirb::EdgeLabel& Label)
+    {
+        Insertions.push_back({Src, Dest, Label});
+    }
+
+    bool empty() const
+    {
+        return Removals.empty() && Insertions.empty();
+    }
+
+    /**
+    Apply the removals and then the insertions to the CFG.
+    */
+    void apply(gtirb::CFG& Cfg) const;
+
+private:
+    struct Insertion
+    {
+        const gtirb::CfgNode* Src;
+        const gtirb::CfgNode* Dest;
+        gtirb::EdgeLabel Label;
+    };
+
+    std::vector<std::pair<const gtirb::CfgNode*, gtirb::EdgeType>> Removals;
+    std::vector<Insertion> Insertions;
+};
+
+#endif // CFG_PATCH_H_
@@ -22,13 +22,17 @@
 //===----------------------------------------------------------------------===//
 #include "DatalogAnalysisPass.h"
 
+#include <algorithm>
 #include <boost/filesystem.hpp>
+#include <fstream>
 namespace fs = boost::filesystem;
 
 #include <gtirb/gtirb.hpp>
 #include <gtirb_pprinter/AuxDataUtils.hpp>
 
 #include "../AuxDataSchema.h"
+#include "../gtirb-decoder/ProgramPool.h"
+#include "DatalogProfiler.h"
 #include "Interpreter.h"
 
 AnalysisPassResult DatalogAnalysisPass::analyze(const gtirb::Module& Module)
@@ -75,7 +79,17 @@ void DatalogAnalysisPass::analyzeImpl(AnalysisPassResult& Result, const gtirb::M
     {
         // Disassemble with the compiled, synthesized program.
         Program->setNumThreads(ThreadCount);
-        bool pruneImdtRels = !WriteSouffleOutputs && DebugDirRoot.empty();
+        bool pruneImdtRels = !keepRelations();
+
+        // Programs generated without `--profile' are profiled by sampling.
+        std::unique_ptr<DatalogProfiler> Profiler;
+#if !defined(DDISASM_SOUFFLE_PROFILING)
+        if(!ProfilePath.empty())
+        {
+            Profiler = std::make_unique<DatalogProfiler>();
+            Profiler->start();
+        }
+#endif
         try
         {
             Program->runAll("", "", false, pruneImdtRels);
@@ -84,6 +98,14 @@ void DatalogAnalysisPass::analyzeImpl(AnalysisPassResult& Result, const gtirb::M
         {
             Result.Errors.push_back(e.what());
         }
+
+        if(Profiler)
+        {
+            Profiler->stop(*Program);
+            fs::path SampledPath = fs::path(ProfilePath).replace_extension(".sampled.json");
+            std::ofstream Stream(SampledPath.string());
+            Profiler->write(Stream, getNameSlug());
+        }
     }
 }
 
@@ -134,7 +156,25 @@ void DatalogAnalysisPass::transformImpl(AnalysisPassResult& Result, gtirb::Conte
     }
 }
 
+std::vector<std::pair<std::string, size_t>> DatalogAnalysisPass::getLargestRelations(
+    size_t Count) const
+{
+    std::vector<std::pair<std::string, size_t>> Sizes;
+    if(Program)
+    {
+        for(souffle::Relation* Relation : Program->getAllRelations())
+        {
+            Sizes.emplace_back(Relation->getName(), Relation->size());
+        }
+    }
+    Count = std::min(Count, Sizes.size());
+    std::partial_sort(Sizes.begin(), Sizes.begin() + Count, Sizes.end(),
+                      [](const auto& A, const auto& B) { return A.second > B.second; });
+    Sizes.resize(Count);
+    return Sizes;
+}
+
 void DatalogAnalysisPass::clear()
 {
-    Program.reset();
+    ProgramPool::instance().release(std::move(Program));
 }
@@ -29,6 +29,7 @@
 #include <list>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "../gtirb-decoder/DatalogIO.h"
 #include "AnalysisPass.h"
@@ -70,6 +71,12 @@ public:
         return *Program;
     };
 
+    /**
+    Get the Count relations with the most tuples. The sizes are read without
+    synchronization, so the program must not be running.
+    */
+    std::vector<std::pair<std::string, size_t>> getLargestRelations(size_t Count) const;
+
     virtual bool hasLoad(void) override
     {
         return true;
@@ -85,6 +92,15 @@ protected:
     */
     virtual std::string getSourceFilename() const = 0;
 
+    /**
+    Whether relations must be kept once they have been consumed: they are
+    written out for inspection, or their tuple counts are profiled.
+    */
+    bool keepRelations() const
+    {
+        return WriteSouffleOutputs || !DebugDirRoot.empty() || !ProfilePath.empty();
+    }
+
     std::string InterpreterPath;
     std::string LibDir;
     std::string ProfilePath;
@@ -0,0 +1,300 @@
+//===- DatalogProfiler.cpp --------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the GNU Affero General Public License
+//  as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version. See the
+//  LICENSE.txt file in the project root for license terms or visit
+//  https://www.gnu.org/licenses/agpl.txt.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU Affero General Public License for more details.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include "DatalogProfiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <regex>
+#include <thread>
+#include <unordered_map>
+
+#if defined(__linux__)
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <signal.h>
+#include <sys/time.h>
+
+namespace
+{
+    constexpr size_t MaxSamples = 1 << 14;
+    constexpr size_t MaxDepth = 32;
+
+    // Call stacks recorded by the SIGPROF handler.
+    struct SampleBuffer
+    {
+        std::vector<void*> Frames = std::vector<void*>(MaxSamples * MaxDepth);
+        std::vector<int> Depths = std::vector<int>(MaxSamples);
+        std::atomic<size_t> Next{0};
+    };
+
+    std::atomic<SampleBuffer*> ActiveBuffer{nullptr};
+    std::atomic<int> HandlersRunning{0};
+
+    void handleSample(int)
+    {
+        // Count the handler as running before loading the buffer, so that
+        // once a swapped-out buffer is seen with no handler running, no
+        // handler writes to it anymore.
+        HandlersRunning.fetch_add(1);
+        if(SampleBuffer* Buffer = ActiveBuffer.load())
+        {
+            size_t I = Buffer->Next.fetch_add(1, std::memory_order_relaxed);
+            if(I < MaxSamples)
+            {
+                Buffer->Depths[I] = backtrace(&Buffer->Frames[I * MaxDepth], MaxDepth);
+            }
+        }
+        HandlersRunning.fetch_sub(1);
+    }
+
+    std::string symbolize(void* Address)
+    {
+        Dl_info Info;
+        if(!dladdr(Address, &Info) || !Info.dli_sname)
+        {
+            return "";
+        }
+        int Status = 0;
+        char* Demangled = abi::__cxa_demangle(Info.dli_sname, nullptr, nullptr, &Status);
+        std::string Name = Status == 0 ? Demangled : Info.dli_sname;
+        free(Demangled);
+        return Name;
+    }
+} // namespace
+
+/**
+The SIGPROF handler records call stacks in one of two buffers while a
+collector thread periodically swaps them and attributes the samples of the
+other one to strata, so long runs are profiled with a bounded buffer.
+*/
+struct DatalogProfiler::Sampler
+{
+    SampleBuffer Buffers[2];
+    int Current = 0;
+
+    std::thread Collector;
+    std::mutex Mutex;
+    std::condition_variable Wakeup;
+    bool StopRequested = false;
+
+    size_t SampleCount = 0;
+    size_t DroppedCount = 0;
+    std::map<std::string, size_t> StratumSamples;
+    std::unordered_map<void*, std::string> Strata;
+    struct sigaction PreviousAction;
+
+    // Attribute the samples of the active buffer after swapping it out.
+    void collect()
+    {
+        SampleBuffer& Buffer = Buffers[Current];
+        Current = 1 - Current;
+        ActiveBuffer.store(&Buffers[Current]);
+        while(HandlersRunning.load() != 0)
+        {
+            std::this_thread::yield();
+        }
+
+        size_t Taken = Buffer.Next.load();
+        size_t Recorded = std::min(Taken, MaxSamples);
+        SampleCount += Taken;
+        DroppedCount += Taken - Recorded;
+        for(size_t I = 0; I < Recorded; ++I)
+        {
+            StratumSamples[findStratum(&Buffer.Frames[I * MaxDepth], Buffer.Depths[I])]++;
+        }
+        Buffer.Next.store(0);
+    }
+
+    std::string findStratum(void** Frames, int Depth)
+    {
+        // Souffle synthesizes the evaluation of each stratum into the run()
+        // method of a class named after the relations it computes.
+        static const std::regex StratumPattern("Stratum_[A-Za-z0-9_]+");
+
+        for(int F = 0; F < Depth; ++F)
+        {
+            auto It = Strata.find(Frames[F]);
+            if(It == Strata.end())
+            {
+                std::smatch Match;
+                std::string Name = symbolize(Frames[F]);
+                std::regex_search(Name, Match, StratumPattern);
+                It = Strata.emplace(Frames[F], Match.empty() ? "" : Match.str()).first;
+            }
+            if(!It->second.empty())
+            {
+                return It->second;
+            }
+        }
+        return "<other>";
+    }
+};
+#else
+struct DatalogProfiler::Sampler
+{
+};
+#endif
+
+DatalogProfiler::DatalogProfiler(std::chrono::microseconds I) : Interval(I)
+{
+}
+
+DatalogProfiler::~DatalogProfiler()
+{
+    stopSampling();
+}
+
+bool DatalogProfiler::isSamplingSupported()
+{
+#if defined(__linux__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void DatalogProfiler::start()
+{
+    StartTime = std::chrono::high_resolution_clock::now();
+    StartClock = std::clock();
+#if defined(__linux__)
+    auto NewSampler = std::make_unique<Sampler>();
+    SampleBuffer* Expected = nullptr;
+    if(!ActiveBuffer.compare_exchange_strong(Expected, &NewSampler->Buffers[0]))
+    {
+        // Another profiler is sampling.
+        return;
+    }
+    ActiveSampler = std::move(NewSampler);
+
+    // backtrace() loads libgcc on its first call, which is not safe to do
+    // in the signal handler.
+    void* Warmup[1];
+    backtrace(Warmup, 1);
+
+    struct sigaction Action = {};
+    Action.sa_handler = handleSample;
+    Action.sa_flags = SA_RESTART;
+    sigemptyset(&Action.sa_mask);
+    sigaction(SIGPROF, &Action, &ActiveSampler->PreviousAction);
+
+    Sampler* S = ActiveSampler.get();
+    S->Collector = std::thread([S]() {
+        std::unique_lock<std::mutex> Lock(S->Mutex);
+        while(!S->Wakeup.wait_for(Lock, std::chrono::milliseconds(100),
+                                  [S]() { return S->StopRequested; }))
+        {
+            S->collect();
+        }
+    });
+
+    struct itimerval Timer = {};
+    Timer.it_interval.tv_sec = Interval.count() / 1000000;
+    Timer.it_interval.tv_usec = Interval.count() % 1000000;
+    Timer.it_value = Timer.it_interval;
+    setitimer(ITIMER_PROF, &Timer, nullptr);
+#endif
+}
+
+void DatalogProfiler::stopSampling()
+{
+#if defined(__linux__)
+    if(!ActiveSampler)
+    {
+        return;
+    }
+    struct itimerval Timer = {};
+    setitimer(ITIMER_PROF, &Timer, nullptr);
+    {
+        std::lock_guard<std::mutex> Lock(ActiveSampler->Mutex);
+        ActiveSampler->StopRequested = true;
+    }
+    ActiveSampler->Wakeup.notify_one();
+    ActiveSampler->Collector.join();
+    ActiveSampler->collect();
+    ActiveBuffer.store(nullptr);
+    while(HandlersRunning.load() != 0)
+    {
+        std::this_thread::yield();
+    }
+    sigaction(SIGPROF, &ActiveSampler->PreviousAction, nullptr);
+
+    SampleCount = ActiveSampler->SampleCount;
+    DroppedCount = ActiveSampler->DroppedCount;
+    StratumSamples = std::move(ActiveSampler->StratumSamples);
+    ActiveSampler.reset();
+#endif
+}
+
+void DatalogProfiler::stop(const souffle::SouffleProgram& Program)
+{
+    stopSampling();
+    WallTime = std::chrono::high_resolution_clock::now() - StartTime;
+    CpuTime = static_cast<double>(std::clock() - StartClock) / CLOCKS_PER_SEC;
+
+    RelationSizes.clear();
+    for(souffle::Relation* Relation : Program.getAllRelations())
+    {
+        RelationSizes.emplace_back(Relation->getName(), Relation->size());
+    }
+    std::sort(RelationSizes.begin(), RelationSizes.end(),
+              [](const auto& A, const auto& B) { return A.second > B.second; });
+}
+
+void DatalogProfiler::write(std::ostream& Stream, const std::string& Name) const
+{
+    std::vector<std::pair<std::string, size_t>> Strata(StratumSamples.begin(),
+                                                       StratumSamples.end());
+    std::sort(Strata.begin(), Strata.end(),
+              [](const auto& A, const auto& B) { return A.second > B.second; });
+    // The timer resolution may be coarser than the interval, so the CPU
+    // time of the run is split among the strata by their share of samples.
+    size_t Attributed = SampleCount - DroppedCount;
+    double SecondsPerSample = Attributed ? CpuTime / Attributed : 0;
+
+    // Pass, stratum and relation names are identifiers; they need no escaping.
+    Stream << "{\n  \"pass\": \"" << Name << "\",\n";
+    Stream << "  \"wall_seconds\": " << WallTime.count() << ",\n";
+    Stream << "  \"cpu_seconds\": " << CpuTime << ",\n";
+    Stream << "  \"sampling\": " << (isSamplingSupported() ? "true" : "false") << ",\n";
+    Stream << "  \"interval_us\": " << Interval.count() << ",\n";
+    Stream << "  \"samples\": " << SampleCount << ",\n";
+    Stream << "  \"dropped\": " << DroppedCount << ",\n";
+    Stream << "  \"strata\": [";
+    for(size_t I = 0; I < Strata.size(); ++I)
+    {
+        Stream << (I ? "," : "") << "\n    {\"name\": \"" << Strata[I].first
+               << "\", \"samples\": " << Strata[I].second
+               << ", \"cpu_seconds\": " << Strata[I].second * SecondsPerSample << "}";
+    }
+    Stream << "\n  ],\n  \"relations\": [";
+    for(size_t I = 0; I < RelationSizes.size(); ++I)
+    {
+        Stream << (I ? "," : "") << "\n    {\"name\": \"" << RelationSizes[I].first
+               << "\", \"tuples\": " << RelationSizes[I].second << "}";
+    }
+    Stream << "\n  ]\n}\n";
+}
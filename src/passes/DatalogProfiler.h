@@ -0,0 +1,86 @@
+//===- DatalogProfiler.h ----------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the GNU Affero General Public License
+//  as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version. See the
+//  LICENSE.txt file in the project root for license terms or visit
+//  https://www.gnu.org/licenses/agpl.txt.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU Affero General Public License for more details.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#ifndef DATALOG_PROFILER_H_
+#define DATALOG_PROFILER_H_
+
+#include <souffle/SouffleInterface.h>
+
+#include <chrono>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+Lightweight profiler for the synthesized Souffle programs, which does not
+require generating them with `--profile'.
+
+While it runs, the profiler samples the call stack of the threads that
+consume CPU time and attributes each sample to the Souffle stratum on the
+stack (Linux only). When it stops, it records the tuple count of every
+relation. Nothing is installed unless a profiler is started, so there is no
+cost when profiling is disabled.
+*/
+class DatalogProfiler
+{
+public:
+    explicit DatalogProfiler(
+        std::chrono::microseconds Interval = std::chrono::microseconds(1000));
+    ~DatalogProfiler();
+
+    DatalogProfiler(const DatalogProfiler&) = delete;
+    DatalogProfiler& operator=(const DatalogProfiler&) = delete;
+
+    // Whether the call stacks can be sampled on this platform.
+    static bool isSamplingSupported();
+
+    // Start sampling. Only one profiler samples at a time.
+    void start();
+
+    // Stop sampling and record the tuple counts of the relations of Program.
+    void stop(const souffle::SouffleProgram& Program);
+
+    // Write the profile as JSON.
+    void write(std::ostream& Stream, const std::string& Name) const;
+
+private:
+    struct Sampler;
+
+    void stopSampling();
+
+    std::chrono::microseconds Interval;
+    std::chrono::time_point<std::chrono::high_resolution_clock> StartTime;
+    std::chrono::duration<double> WallTime{0};
+    std::clock_t StartClock = 0;
+    double CpuTime = 0;
+    std::unique_ptr<Sampler> ActiveSampler;
+
+    size_t SampleCount = 0;
+    size_t DroppedCount = 0;
+    std::map<std::string, size_t> StratumSamples;
+    std::vector<std::pair<std::string, size_t>> RelationSizes;
+};
+
+#endif // DATALOG_PROFILER_H_
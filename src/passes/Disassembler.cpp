@@ -23,7 +23,10 @@
 
 #include "Disassembler.h"
 
+#include <algorithm>
+#include <array>
 #include <boost/uuid/uuid_generators.hpp>
+#include <functional>
 #include <regex>
 
 #include "../AuxDataSchema.h"
@@ -50,67 +53,72 @@ souffle::tuple &operator>>(souffle::tuple &t, uint8_t &byte)
     return t;
 }
 
+using DecodedOperand = std::variant<std::monostate, ImmOp, IndirectOp>;
+
 struct DecodedInstruction
 {
-    std::map<uint64_t, std::variant<ImmOp, IndirectOp>> Operands;
-    uint64_t immediateOffset;
-    uint64_t displacementOffset;
+    gtirb::Addr EA{0};
+    std::array<DecodedOperand, 4> Operands;
+    uint64_t immediateOffset{0};
+    uint64_t displacementOffset{0};
 };
 
-std::map<gtirb::Addr, DecodedInstruction> recoverInstructions(souffle::SouffleProgram &Program,
-                                                              std::set<gtirb::Addr> &Code)
+// Recover the operands of the instructions in Code (sorted), returned in the
+// same order as Code. Operand codes are dense, so operands are indexed by code.
+std::vector<DecodedInstruction> recoverInstructions(souffle::SouffleProgram &Program,
+                                                    const std::vector<gtirb::Addr> &Code)
 {
-    std::map<uint64_t, ImmOp> Immediates;
+    std::vector<DecodedOperand> OperandTable;
+    auto addOperand = [&OperandTable](uint64_t OperandCode, DecodedOperand &&Operand) {
+        if(OperandTable.size() <= OperandCode)
+        {
+            OperandTable.resize(OperandCode + 1);
+        }
+        OperandTable[OperandCode] = std::move(Operand);
+    };
     for(auto &Output : *Program.getRelation("op_immediate"))
     {
         uint64_t OperandCode, Size;
         ImmOp Immediate;
         Output >> OperandCode >> Immediate >> Size;
-        Immediates[OperandCode] = Immediate;
+        addOperand(OperandCode, Immediate);
     };
-    std::map<uint64_t, IndirectOp> Indirects;
     for(auto &Output : *Program.getRelation("op_indirect"))
     {
         uint64_t OperandCode, Size;
         IndirectOp Indirect;
         Output >> OperandCode >> Indirect.Reg1 >> Indirect.Reg2 >> Indirect.Reg3 >> Indirect.Mult
             >> Indirect.Disp >> Size;
-        Indirects[OperandCode] = Indirect;
+        addOperand(OperandCode, std::move(Indirect));
     };
 
-    std::map<gtirb::Addr, DecodedInstruction> Insns;
+    std::vector<DecodedInstruction> Insns(Code.size());
     for(auto &Output : *Program.getRelation("instruction"))
     {
         gtirb::Addr EA;
         Output >> EA;
 
         // Don't bother recovering instructions that aren't considered code.
-        if(Code.count(EA) == 0)
+        auto It = std::lower_bound(Code.begin(), Code.end(), EA);
+        if(It == Code.end() || *It != EA)
         {
             continue;
         }
 
-        DecodedInstruction Insn;
+        DecodedInstruction &Insn = Insns[It - Code.begin()];
+        Insn.EA = EA;
         uint64_t Size;
         std::string Prefix, Opcode;
         Output >> Size >> Prefix >> Opcode;
 
-        for(size_t i = 1; i <= 4; i++)
+        for(size_t i = 0; i < Insn.Operands.size(); i++)
         {
             uint64_t OperandIndex;
             Output >> OperandIndex;
-            auto FoundImmediate = Immediates.find(OperandIndex);
-            if(FoundImmediate != Immediates.end())
-                Insn.Operands[i] = FoundImmediate->second;
-            else
-            {
-                auto FoundIndirect = Indirects.find(OperandIndex);
-                if(FoundIndirect != Indirects.end())
-                    Insn.Operands[i] = FoundIndirect->second;
-            }
+            if(OperandIndex < OperandTable.size())
+                Insn.Operands[i] = OperandTable[OperandIndex];
         }
         Output >> Insn.immediateOffset >> Insn.displacementOffset;
-        Insns[EA] = Insn;
     }
     return Insns;
 }
@@ -256,6 +264,185 @@ struct SymbolicInfo
     VectorByEA<SymbolicExprAttribute> SymbolicExprAttributes;
 };
 
+gtirb::EdgeType getEdgeType(const std::string &type)
+{
+    if(type == "branch")
+        return gtirb::EdgeType::Branch;
+    if(type == "call")
+        return gtirb::EdgeType::Call;
+    if(type == "return")
+        return gtirb::EdgeType::Return;
+    // TODO syscall and sysret
+    return gtirb::EdgeType::Fallthrough;
+}
+
+struct CfgEdge
+{
+    explicit CfgEdge(souffle::tuple &T)
+    {
+        assert(T.size() == 5);
+        std::string Conditional, Indirect, Type;
+        T >> Src >> Dest >> Conditional >> Indirect >> Type;
+        IsConditional = Conditional == "true" ? gtirb::ConditionalEdge::OnTrue
+                                              : gtirb::ConditionalEdge::OnFalse;
+        IsIndirect =
+            Indirect == "true" ? gtirb::DirectEdge::IsIndirect : gtirb::DirectEdge::IsDirect;
+        EdgeType = getEdgeType(Type);
+    }
+    gtirb::Addr Src{0};
+    gtirb::Addr Dest{0};
+    gtirb::ConditionalEdge IsConditional;
+    gtirb::DirectEdge IsIndirect;
+    gtirb::EdgeType EdgeType;
+};
+
+struct CfiDirective
+{
+    explicit CfiDirective(souffle::tuple &T)
+    {
+        assert(T.size() == 8);
+        T >> BlockAddr >> Disp >> LocalIndex >> Directive >> Reference >> NumOperands >> Op1 >> Op2;
+    }
+    gtirb::Addr BlockAddr{0};
+    uint64_t Disp{0};
+    uint64_t LocalIndex{0};
+    std::string Directive;
+    std::string Reference;
+    uint64_t NumOperands{0};
+    int64_t Op1{0};
+    int64_t Op2{0};
+};
+
+// Output relations converted to C++ containers before the GTIRB is built.
+// The conversions only read the Souffle program, so they can run concurrently.
+struct OutputRelations
+{
+    VectorByEA<BlockInformation> BlockInfo;
+    SymbolicInfo Symbolic;
+    VectorByEA<StringDataObject> DataStrings;
+    VectorByEA<SymbolSpecialType> SymbolSpecialTypes;
+    std::set<gtirb::Addr> DataBoundary;
+    std::set<gtirb::Addr> BssData;
+    VectorByEA<Alignment> Alignments;
+    std::vector<gtirb::Addr> Code;
+    std::vector<DecodedInstruction> DecodedInstructions;
+    std::vector<CfgEdge> CfgEdges;
+    std::vector<CfiDirective> CfiDirectives;
+    std::vector<std::pair<gtirb::Addr, uint64_t>> Padding;
+};
+
+// Address index of the module that is being rebuilt. The byte intervals are
+// indexed once, and the blocks are recorded as they are created, so that
+// building the GTIRB does not need an interval lookup in the module for every
+// output tuple.
+class ModuleIndex
+{
+public:
+    explicit ModuleIndex(gtirb::Module &M) : Module(M)
+    {
+        for(auto &ByteInterval : Module.byte_intervals())
+        {
+            if(ByteInterval.getAddress() && ByteInterval.getSize() > 0)
+            {
+                ByteIntervals.emplace_back(*ByteInterval.getAddress(), &ByteInterval);
+            }
+        }
+        std::stable_sort(ByteIntervals.begin(), ByteIntervals.end(),
+                         [](const auto &A, const auto &B) { return A.first < B.first; });
+    }
+
+    gtirb::ByteInterval *findByteInterval(gtirb::Addr Addr) const
+    {
+        auto It =
+            std::upper_bound(ByteIntervals.begin(), ByteIntervals.end(), Addr,
+                             [](gtirb::Addr A, const auto &Entry) { return A < Entry.first; });
+        if(It != ByteIntervals.begin())
+        {
+            --It;
+            if(Addr < It->first + It->second->getSize())
+            {
+                return It->second;
+            }
+        }
+        // Byte intervals may overlap, fall back to the module lookup.
+        if(auto Found = Module.findByteIntervalsOn(Addr); !Found.empty())
+        {
+            return &*Found.begin();
+        }
+        return nullptr;
+    }
+
+    void addCodeBlock(gtirb::Addr Addr, gtirb::CodeBlock *Block)
+    {
+        CodeBlocks.emplace(Addr, Block);
+    }
+
+    void addDataBlock(gtirb::Addr Addr, gtirb::DataBlock *Block)
+    {
+        DataBlocks.emplace(Addr, Block);
+    }
+
+    // Find the lowest-address code block that contains Addr, i.e. the first
+    // block of Module.findCodeBlocksOn(Addr), as code blocks may overlap.
+    gtirb::CodeBlock *findCodeBlockOn(gtirb::Addr Addr) const
+    {
+        if(CodeBlockCover.size() != CodeBlocks.size())
+        {
+            indexCodeBlockCover();
+        }
+        // The ends are running maxima, so the first one past Addr is that of
+        // the lowest block ending past Addr, which contains Addr if it starts
+        // at or before it.
+        auto It = std::upper_bound(
+            CodeBlockCover.begin(), CodeBlockCover.end(), Addr,
+            [](gtirb::Addr A, const auto &Entry) { return A < Entry.first; });
+        if(It != CodeBlockCover.end() && *It->second->getAddress() <= Addr)
+        {
+            return It->second;
+        }
+        if(auto Found = Module.findCodeBlocksOn(Addr); !Found.empty())
+        {
+            return &*Found.begin();
+        }
+        return nullptr;
+    }
+
+    gtirb::Node *findBlockAt(gtirb::Addr Addr) const
+    {
+        if(auto It = CodeBlocks.find(Addr); It != CodeBlocks.end())
+        {
+            return It->second;
+        }
+        if(auto It = DataBlocks.find(Addr); It != DataBlocks.end())
+        {
+            return It->second;
+        }
+        return nullptr;
+    }
+
+private:
+    // Rebuild the cover of the code blocks once they have all been added.
+    void indexCodeBlockCover() const
+    {
+        CodeBlockCover.clear();
+        CodeBlockCover.reserve(CodeBlocks.size());
+        gtirb::Addr MaxEnd;
+        for(const auto &[Addr, Block] : CodeBlocks)
+        {
+            MaxEnd = std::max(MaxEnd, Addr + Block->getSize());
+            CodeBlockCover.emplace_back(MaxEnd, Block);
+        }
+    }
+
+    gtirb::Module &Module;
+    std::vector<std::pair<gtirb::Addr, gtirb::ByteInterval *>> ByteIntervals;
+    std::map<gtirb::Addr, gtirb::CodeBlock *> CodeBlocks;
+    // The code blocks in address order, each with the largest end address of
+    // the blocks up to it. Built lazily by findCodeBlockOn.
+    mutable std::vector<std::pair<gtirb::Addr, gtirb::CodeBlock *>> CodeBlockCover;
+    std::map<gtirb::Addr, gtirb::DataBlock *> DataBlocks;
+};
+
 template <typename Container, typename Elem = typename Container::value_type>
 Container convertSortedRelation(const std::string &relation, souffle::SouffleProgram &Program)
 {
@@ -280,6 +467,101 @@ std::set<gtirb::Addr> convertSortedRelation<std::set<gtirb::Addr>>(const std::st
     return result;
 }
 
+template <typename T>
+std::vector<T> convertRelation(const std::string &Relation, souffle::SouffleProgram &Program)
+{
+    std::vector<T> Result;
+    if(souffle::Relation *R = Program.getRelation(Relation))
+    {
+        Result.reserve(R->size());
+        for(auto &Output : *R)
+        {
+            Result.emplace_back(Output);
+        }
+    }
+    return Result;
+}
+
+// Build an AuxData map from entries collected in a vector reserved from the
+// relation sizes. The entries are sorted first so that every insertion is
+// hinted at the end of the map, instead of rebalancing the map at random.
+// As with assignments to the map, the last entry of a duplicate key wins.
+template <typename Key, typename Value>
+std::map<Key, Value> toSortedMap(std::vector<std::pair<Key, Value>> &&Entries)
+{
+    std::stable_sort(Entries.begin(), Entries.end(),
+                     [](const auto &A, const auto &B) { return A.first < B.first; });
+    std::map<Key, Value> Result;
+    for(auto &[K, V] : Entries)
+    {
+        Result.insert_or_assign(Result.end(), std::move(K), std::move(V));
+    }
+    return Result;
+}
+
+OutputRelations extractOutputRelations(souffle::SouffleProgram &Program, const Executor &Exec)
+{
+    OutputRelations Relations;
+    // Each task fills a different member of Relations. The tasks only read
+    // the program: in Souffle 2.4 the symbol table is a ConcurrentFlyweight,
+    // whose decode is safe even alongside the encodes of parallel evaluation,
+    // and relations are only iterated, which is safe once evaluation is over.
+    std::vector<std::function<void()>> Tasks = {
+        [&]() {
+            for(auto &Output : *Program.getRelation("code_in_refined_block"))
+            {
+                Relations.Code.push_back(gtirb::Addr(Output[0]));
+            }
+            std::sort(Relations.Code.begin(), Relations.Code.end());
+            Relations.Code.erase(std::unique(Relations.Code.begin(), Relations.Code.end()),
+                                 Relations.Code.end());
+            Relations.DecodedInstructions = recoverInstructions(Program, Relations.Code);
+        },
+        [&]() {
+            Relations.BlockInfo =
+                convertSortedRelation<VectorByEA<BlockInformation>>("block_information", Program);
+        },
+        [&]() {
+            Relations.Symbolic.SymbolicExprs =
+                convertSortedRelation<VectorByEA<SymbolicExpr>>("symbolic_expr", Program);
+        },
+        [&]() {
+            Relations.Symbolic.SymbolMinusSymbolSymbolicExprs =
+                convertSortedRelation<VectorByEA<SymExprSymbolMinusSymbol>>(
+                    "symbolic_expr_symbol_minus_symbol", Program);
+        },
+        [&]() {
+            Relations.Symbolic.SymbolicExprAttributes =
+                convertSortedRelation<VectorByEA<SymbolicExprAttribute>>("symbolic_expr_attribute",
+                                                                         Program);
+        },
+        [&]() {
+            Relations.DataStrings =
+                convertSortedRelation<VectorByEA<StringDataObject>>("string", Program);
+            Relations.SymbolSpecialTypes = convertSortedRelation<VectorByEA<SymbolSpecialType>>(
+                "symbol_special_encoding", Program);
+            Relations.DataBoundary =
+                convertSortedRelation<std::set<gtirb::Addr>>("data_object_boundary", Program);
+            Relations.BssData = convertSortedRelation<std::set<gtirb::Addr>>("bss_data", Program);
+            Relations.Alignments =
+                convertSortedRelation<VectorByEA<Alignment>>("alignment", Program);
+        },
+        [&]() { Relations.CfgEdges = convertRelation<CfgEdge>("cfg_edge", Program); },
+        [&]() {
+            Relations.CfiDirectives = convertRelation<CfiDirective>("cfi_directive", Program);
+            for(auto &Output : *Program.getRelation("padding"))
+            {
+                gtirb::Addr EA;
+                uint64_t Size;
+                Output >> EA >> Size;
+                Relations.Padding.emplace_back(EA, Size);
+            }
+        }};
+
+    Exec.run(Tasks);
+    return Relations;
+}
+
 std::string stripSymbolVersion(const std::string Name)
 {
     if(size_t I = Name.find('@'); I != std::string::npos)
@@ -576,13 +858,12 @@ void expandSymbolForwarding(gtirb::Module &Module, souffle::SouffleProgram &Prog
 }
 
 template <class ExprType, typename... Args>
-void addSymbolicExpressionToCodeBlock(gtirb::Module &Module, gtirb::Addr Addr, uint64_t Size,
-                                      Args... A)
+void addSymbolicExpressionToCodeBlock(gtirb::Module &Module, const ModuleIndex &Index,
+                                      gtirb::Addr Addr, uint64_t Size, Args... A)
 {
-    if(auto it = Module.findCodeBlocksOn(Addr); !it.empty())
+    if(gtirb::CodeBlock *Block = Index.findCodeBlockOn(Addr))
     {
-        gtirb::CodeBlock &Block = *it.begin();
-        gtirb::ByteInterval *ByteInterval = Block.getByteInterval();
+        gtirb::ByteInterval *ByteInterval = Block->getByteInterval();
         std::optional<gtirb::Addr> BaseAddr = ByteInterval->getAddress();
         assert(BaseAddr && "Found byte interval without address.");
         // In ARM we substract one for symexprs in thumb mode.
@@ -600,7 +881,7 @@ void addSymbolicExpressionToCodeBlock(gtirb::Module &Module, gtirb::Addr Addr, u
     }
 }
 
-void buildSymbolicExpr(gtirb::Module &Module, const gtirb::Addr &Ea,
+void buildSymbolicExpr(gtirb::Module &Module, const ModuleIndex &Index, const gtirb::Addr &Ea,
                        const SymbolicInfo &SymbolicInfo)
 {
     gtirb::SymAttributeSet Attrs =
@@ -611,8 +892,8 @@ void buildSymbolicExpr(gtirb::Module &Module, const gtirb::Addr &Ea,
     {
         gtirb::Symbol *FoundSymbol = findFirstSymbol(Module, SymExpr->Symbol);
         // FIXME: We need to handle overlapping sections here.
-        addSymbolicExpressionToCodeBlock<gtirb::SymAddrConst>(Module, Ea, SymExpr->Size,
-                                                              SymExpr->Addend, FoundSymbol, Attrs);
+        addSymbolicExpressionToCodeBlock<gtirb::SymAddrConst>(
+            Module, Index, Ea, SymExpr->Size, SymExpr->Addend, FoundSymbol, Attrs);
         // Symbol-Symbol case
     }
     else if(const auto SymExpr = SymbolicInfo.SymbolMinusSymbolSymbolicExprs.find(Ea);
@@ -621,77 +902,72 @@ void buildSymbolicExpr(gtirb::Module &Module, const gtirb::Addr &Ea,
         gtirb::Symbol *FoundSymbol1 = findFirstSymbol(Module, SymExpr->Symbol1);
         gtirb::Symbol *FoundSymbol2 = findFirstSymbol(Module, SymExpr->Symbol2);
         addSymbolicExpressionToCodeBlock<gtirb::SymAddrAddr>(
-            Module, Ea, SymExpr->Size, static_cast<int64_t>(SymExpr->Scale), SymExpr->Offset,
-            FoundSymbol2, FoundSymbol1, Attrs);
+            Module, Index, Ea, SymExpr->Size, static_cast<int64_t>(SymExpr->Scale),
+            SymExpr->Offset, FoundSymbol2, FoundSymbol1, Attrs);
     }
 }
 
-void buildCodeSymbolicInformation(gtirb::Module &Module, souffle::SouffleProgram &Program)
+void buildCodeSymbolicInformation(gtirb::Module &Module, const ModuleIndex &Index,
+                                  const OutputRelations &Relations)
 {
-    std::set<gtirb::Addr> Code;
-    for(auto &output : *Program.getRelation("code_in_refined_block"))
-    {
-        gtirb::Addr EA;
-        output >> EA;
-        Code.insert(EA);
-    }
+    const SymbolicInfo &symbolicInfo = Relations.Symbolic;
 
-    SymbolicInfo symbolicInfo{
-        convertSortedRelation<VectorByEA<SymbolicExpr>>("symbolic_expr", Program),
-        convertSortedRelation<VectorByEA<SymExprSymbolMinusSymbol>>(
-            "symbolic_expr_symbol_minus_symbol", Program),
-        convertSortedRelation<VectorByEA<SymbolicExprAttribute>>("symbolic_expr_attribute",
-                                                                 Program)};
-    std::map<gtirb::Addr, DecodedInstruction> decodedInstructions =
-        recoverInstructions(Program, Code);
-
-    for(auto &EA : Code)
+    for(const DecodedInstruction &Inst : Relations.DecodedInstructions)
     {
-        const auto Inst = decodedInstructions.find(EA);
-        assert(Inst != decodedInstructions.end());
-        for(auto &Op : Inst->second.Operands)
+        for(auto &Op : Inst.Operands)
         {
-            if(std::get_if<ImmOp>(&Op.second))
-                buildSymbolicExpr(Module, gtirb::Addr(Inst->first + Inst->second.immediateOffset),
+            if(std::get_if<ImmOp>(&Op))
+                buildSymbolicExpr(Module, Index, gtirb::Addr(Inst.EA + Inst.immediateOffset),
                                   symbolicInfo);
-            if(std::get_if<IndirectOp>(&Op.second))
-                buildSymbolicExpr(Module,
-                                  gtirb::Addr(Inst->first + Inst->second.displacementOffset),
+            if(std::get_if<IndirectOp>(&Op))
+                buildSymbolicExpr(Module, Index, gtirb::Addr(Inst.EA + Inst.displacementOffset),
                                   symbolicInfo);
         }
     }
 }
 
-void buildCodeBlocks(gtirb::Context &Context, gtirb::Module &Module,
-                     souffle::SouffleProgram &Program)
+struct PendingCodeBlock
+{
+    gtirb::Addr Address;
+    uint64_t Offset;
+    uint64_t Size;
+    gtirb::DecodeMode DecodeMode;
+};
+
+void buildCodeBlocks(gtirb::Context &Context, gtirb::Module &Module, ModuleIndex &Index,
+                     const OutputRelations &Relations, souffle::SouffleProgram &Program)
 {
-    auto BlockInfo =
-        convertSortedRelation<VectorByEA<BlockInformation>>("block_information", Program);
+    const auto &BlockInfo = Relations.BlockInfo;
 
+    // Group the blocks by byte interval so that each interval receives its
+    // blocks in a single sorted batch.
+    std::map<gtirb::ByteInterval *, std::vector<PendingCodeBlock>> Pending;
     for(auto &Tuple : *Program.getRelation("refined_block"))
     {
         gtirb::Addr BlockAddress;
         Tuple >> BlockAddress;
 
-        if(auto Sections = Module.findSectionsOn(BlockAddress); !Sections.empty())
+        if(gtirb::ByteInterval *ByteInterval = Index.findByteInterval(BlockAddress))
         {
-            gtirb::Section &Section = *Sections.begin();
             uint64_t BlockSize = BlockInfo.find(BlockAddress)->size;
-            if(auto It = Section.findByteIntervalsOn(BlockAddress); !It.empty())
+            uint64_t BlockOffset = BlockAddress - *ByteInterval->getAddress();
+            gtirb::DecodeMode DecodeMode = gtirb::DecodeMode::Default;
+            if((static_cast<uint64_t>(BlockAddress) & 1) && (Module.getISA() == gtirb::ISA::ARM))
             {
-                if(gtirb::ByteInterval &ByteInterval = *It.begin(); ByteInterval.getAddress())
-                {
-                    uint64_t BlockOffset = BlockAddress - *ByteInterval.getAddress();
-                    gtirb::DecodeMode DecodeMode = gtirb::DecodeMode::Default;
-                    if((static_cast<uint64_t>(BlockAddress) & 1)
-                       && (Module.getISA() == gtirb::ISA::ARM))
-                    {
-                        DecodeMode = gtirb::DecodeMode::Thumb;
-                    }
-                    ByteInterval.addBlock<gtirb::CodeBlock>(Context, BlockOffset, BlockSize,
-                                                            DecodeMode);
-                }
+                DecodeMode = gtirb::DecodeMode::Thumb;
             }
+            Pending[ByteInterval].push_back({BlockAddress, BlockOffset, BlockSize, DecodeMode});
+        }
+    }
+    for(auto &[ByteInterval, Blocks] : Pending)
+    {
+        std::sort(Blocks.begin(), Blocks.end(),
+                  [](const auto &A, const auto &B) { return A.Offset < B.Offset; });
+        for(const PendingCodeBlock &Block : Blocks)
+        {
+            gtirb::CodeBlock *CodeBlock = ByteInterval->addBlock<gtirb::CodeBlock>(
+                Context, Block.Offset, Block.Size, Block.DecodeMode);
+            Index.addCodeBlock(Block.Address, CodeBlock);
         }
     }
 }
@@ -699,9 +975,10 @@ void buildCodeBlocks(gtirb::Context &Context, gtirb::Module &Module,
 // Create DataObjects for labeled objects in the BSS sections, without adding
 // data to the ImageByteMap.
 
-void buildBSS(gtirb::Context &context, gtirb::Module &module, souffle::SouffleProgram &Program)
+void buildBSS(gtirb::Context &context, gtirb::Module &module, ModuleIndex &Index,
+              const OutputRelations &Relations, souffle::SouffleProgram &Program)
 {
-    auto bssData = convertSortedRelation<std::set<gtirb::Addr>>("bss_data", Program);
+    const auto &bssData = Relations.BssData;
     for(auto &output : *Program.getRelation("bss_section"))
     {
         std::string sectionName;
@@ -718,36 +995,34 @@ void buildBSS(gtirb::Context &context, gtirb::Module &module, souffle::SoufflePr
             {
                 auto next = i;
                 next++;
-                if(auto it = module.findByteIntervalsOn(*i); !it.empty())
+                if(gtirb::ByteInterval *byteInterval = Index.findByteInterval(*i))
                 {
-                    gtirb::ByteInterval &byteInterval = *it.begin();
-                    uint64_t blockOffset = *i - byteInterval.getAddress().value();
-                    byteInterval.addBlock<gtirb::DataBlock>(context, blockOffset,
-                                                            static_cast<uint64_t>(*next - *i));
+                    uint64_t blockOffset = *i - byteInterval->getAddress().value();
+                    gtirb::DataBlock *dataBlock = byteInterval->addBlock<gtirb::DataBlock>(
+                        context, blockOffset, static_cast<uint64_t>(*next - *i));
+                    Index.addDataBlock(*i, dataBlock);
                 }
             }
         }
     }
 }
 
-void buildDataBlocks(gtirb::Context &Context, gtirb::Module &Module,
-                     souffle::SouffleProgram &Program)
+void buildDataBlocks(gtirb::Context &Context, gtirb::Module &Module, ModuleIndex &Index,
+                     const OutputRelations &Relations, souffle::SouffleProgram &Program)
 {
-    auto SymbolicExprs = convertSortedRelation<VectorByEA<SymbolicExpr>>("symbolic_expr", Program);
-    auto SymbolMinusSymbol = convertSortedRelation<VectorByEA<SymExprSymbolMinusSymbol>>(
-        "symbolic_expr_symbol_minus_symbol", Program);
+    const auto &SymbolicExprs = Relations.Symbolic.SymbolicExprs;
+    const auto &SymbolMinusSymbol = Relations.Symbolic.SymbolMinusSymbolSymbolicExprs;
 
-    auto DataStrings = convertSortedRelation<VectorByEA<StringDataObject>>("string", Program);
-    auto SymbolSpecialTypes =
-        convertSortedRelation<VectorByEA<SymbolSpecialType>>("symbol_special_encoding", Program);
-    auto DataBoundary =
-        convertSortedRelation<std::set<gtirb::Addr>>("data_object_boundary", Program);
-    auto SymbolicExprAttributes = convertSortedRelation<VectorByEA<SymbolicExprAttribute>>(
-        "symbolic_expr_attribute", Program);
+    const auto &DataStrings = Relations.DataStrings;
+    const auto &SymbolSpecialTypes = Relations.SymbolSpecialTypes;
+    std::set<gtirb::Addr> DataBoundary = Relations.DataBoundary;
+    const auto &SymbolicExprAttributes = Relations.Symbolic.SymbolicExprAttributes;
 
-    std::map<gtirb::UUID, std::string> TypesTable;
+    std::vector<std::pair<gtirb::UUID, std::string>> TypesTable;
+    TypesTable.reserve(DataStrings.size() + SymbolSpecialTypes.size());
 
-    std::map<gtirb::Offset, uint64_t> SymbolicSizes;
+    std::vector<std::pair<gtirb::Offset, uint64_t>> SymbolicSizes;
+    SymbolicSizes.reserve(SymbolicExprs.size() + SymbolMinusSymbol.size());
 
     for(auto &Output : *Program.getRelation("initialized_data_segment"))
     {
@@ -759,63 +1034,63 @@ void buildDataBlocks(gtirb::Context &Context, gtirb::Module &Module,
             /*incremented in each case*/)
         {
             gtirb::DataBlock *DataBlock = nullptr;
-            if(auto It = Module.findByteIntervalsOn(CurrentAddr); !It.empty())
+            const std::string *Type = nullptr;
+            if(gtirb::ByteInterval *ByteInterval = Index.findByteInterval(CurrentAddr))
             {
-                if(gtirb::ByteInterval &ByteInterval = *It.begin(); ByteInterval.getAddress())
+                // do not cross byte intervals.
+                DataBoundary.insert(*ByteInterval->getAddress() + ByteInterval->getSize());
+                uint64_t blockOffset = CurrentAddr - *ByteInterval->getAddress();
+                gtirb::Offset Offset = gtirb::Offset(ByteInterval->getUUID(), blockOffset);
+
+                // symbolic expression created from relocation
+                if(const auto SymExpr = SymbolicExprs.find(CurrentAddr);
+                   SymExpr != SymbolicExprs.end())
                 {
-                    // do not cross byte intervals.
-                    DataBoundary.insert(*ByteInterval.getAddress() + ByteInterval.getSize());
-                    uint64_t blockOffset = CurrentAddr - *ByteInterval.getAddress();
-                    gtirb::Offset Offset = gtirb::Offset(ByteInterval.getUUID(), blockOffset);
-
-                    // symbolic expression created from relocation
-                    if(const auto SymExpr = SymbolicExprs.find(CurrentAddr);
-                       SymExpr != SymbolicExprs.end())
-                    {
-                        DataBlock = gtirb::DataBlock::Create(Context, SymExpr->Size);
-                        gtirb::Symbol *foundSymbol = findFirstSymbol(Module, SymExpr->Symbol);
-                        gtirb::SymAttributeSet Attributes =
-                            buildSymbolicExpressionAttributes(CurrentAddr, SymbolicExprAttributes);
-
-                        ByteInterval.addSymbolicExpression<gtirb::SymAddrConst>(
-                            blockOffset, SymExpr->Addend, foundSymbol, Attributes);
-                        SymbolicSizes[Offset] = SymExpr->Size;
-                    }
-                    else if(const auto SymExprSymMinusSym = SymbolMinusSymbol.find(CurrentAddr);
-                            SymExprSymMinusSym != SymbolMinusSymbol.end())
-                    {
-                        DataBlock = gtirb::DataBlock::Create(Context, SymExprSymMinusSym->Size);
-                        gtirb::Symbol *Sym1 = findFirstSymbol(Module, SymExprSymMinusSym->Symbol1);
-                        gtirb::Symbol *Sym2 = findFirstSymbol(Module, SymExprSymMinusSym->Symbol2);
-                        gtirb::SymAttributeSet Attributes =
-                            buildSymbolicExpressionAttributes(CurrentAddr, SymbolicExprAttributes);
-
-                        ByteInterval.addSymbolicExpression<gtirb::SymAddrAddr>(
-                            blockOffset, static_cast<int64_t>(SymExprSymMinusSym->Scale),
-                            SymExprSymMinusSym->Offset, Sym2, Sym1, Attributes);
-                        SymbolicSizes[Offset] = SymExprSymMinusSym->Size;
-                    }
-                    else
-                        // string
-                        if(const auto S = DataStrings.find(CurrentAddr); S != DataStrings.end())
-                    {
-                        DataBlock = gtirb::DataBlock::Create(Context, S->End - CurrentAddr);
-                        TypesTable[DataBlock->getUUID()] = S->Encoding;
-                    }
-                    else
-                    {
-                        // Accumulate region with no symbols into a single DataBlock.
-                        auto NextDataObject = DataBoundary.lower_bound(CurrentAddr + 1);
-                        DataBlock =
-                            gtirb::DataBlock::Create(Context, *NextDataObject - CurrentAddr);
-                    }
-                    // symbol special types
-                    const auto specialType = SymbolSpecialTypes.find(CurrentAddr);
-                    if(specialType != SymbolSpecialTypes.end())
-                        TypesTable[DataBlock->getUUID()] = specialType->Type;
-                    ByteInterval.addBlock(blockOffset, DataBlock);
-                    CurrentAddr += DataBlock->getSize();
+                    DataBlock = gtirb::DataBlock::Create(Context, SymExpr->Size);
+                    gtirb::Symbol *foundSymbol = findFirstSymbol(Module, SymExpr->Symbol);
+                    gtirb::SymAttributeSet Attributes =
+                        buildSymbolicExpressionAttributes(CurrentAddr, SymbolicExprAttributes);
+
+                    ByteInterval->addSymbolicExpression<gtirb::SymAddrConst>(
+                        blockOffset, SymExpr->Addend, foundSymbol, Attributes);
+                    SymbolicSizes.emplace_back(Offset, SymExpr->Size);
+                }
+                else if(const auto SymExprSymMinusSym = SymbolMinusSymbol.find(CurrentAddr);
+                        SymExprSymMinusSym != SymbolMinusSymbol.end())
+                {
+                    DataBlock = gtirb::DataBlock::Create(Context, SymExprSymMinusSym->Size);
+                    gtirb::Symbol *Sym1 = findFirstSymbol(Module, SymExprSymMinusSym->Symbol1);
+                    gtirb::Symbol *Sym2 = findFirstSymbol(Module, SymExprSymMinusSym->Symbol2);
+                    gtirb::SymAttributeSet Attributes =
+                        buildSymbolicExpressionAttributes(CurrentAddr, SymbolicExprAttributes);
+
+                    ByteInterval->addSymbolicExpression<gtirb::SymAddrAddr>(
+                        blockOffset, static_cast<int64_t>(SymExprSymMinusSym->Scale),
+                        SymExprSymMinusSym->Offset, Sym2, Sym1, Attributes);
+                    SymbolicSizes.emplace_back(Offset, SymExprSymMinusSym->Size);
                 }
+                else
+                    // string
+                    if(const auto S = DataStrings.find(CurrentAddr); S != DataStrings.end())
+                {
+                    DataBlock = gtirb::DataBlock::Create(Context, S->End - CurrentAddr);
+                    Type = &S->Encoding;
+                }
+                else
+                {
+                    // Accumulate region with no symbols into a single DataBlock.
+                    auto NextDataObject = DataBoundary.lower_bound(CurrentAddr + 1);
+                    DataBlock = gtirb::DataBlock::Create(Context, *NextDataObject - CurrentAddr);
+                }
+                // symbol special types
+                const auto specialType = SymbolSpecialTypes.find(CurrentAddr);
+                if(specialType != SymbolSpecialTypes.end())
+                    Type = &specialType->Type;
+                if(Type)
+                    TypesTable.emplace_back(DataBlock->getUUID(), *Type);
+                ByteInterval->addBlock(blockOffset, DataBlock);
+                Index.addDataBlock(CurrentAddr, DataBlock);
+                CurrentAddr += DataBlock->getSize();
             }
             else
             {
@@ -824,14 +1099,16 @@ void buildDataBlocks(gtirb::Context &Context, gtirb::Module &Module,
             }
         }
     }
-    buildBSS(Context, Module, Program);
-    Module.addAuxData<gtirb::schema::Encodings>(std::move(TypesTable));
-    Module.addAuxData<gtirb::schema::SymbolicExpressionSizes>(std::move(SymbolicSizes));
+    buildBSS(Context, Module, Index, Relations, Program);
+    Module.addAuxData<gtirb::schema::Encodings>(toSortedMap(std::move(TypesTable)));
+    Module.addAuxData<gtirb::schema::SymbolicExpressionSizes>(
+        toSortedMap(std::move(SymbolicSizes)));
 }
 
-void buildAlignments(gtirb::Module &Module, souffle::SouffleProgram &Program)
+void buildAlignments(gtirb::Module &Module, const ModuleIndex &Index,
+                     const OutputRelations &Relations)
 {
-    auto Alignments = convertSortedRelation<VectorByEA<Alignment>>("alignment", Program);
+    const auto &Alignments = Relations.Alignments;
 
     auto *Alignment = Module.getAuxData<gtirb::schema::Alignment>();
     if(!Alignment)
@@ -844,10 +1121,9 @@ void buildAlignments(gtirb::Module &Module, souffle::SouffleProgram &Program)
 
     for(auto &AlignInfo : Alignments)
     {
-        if(auto BlockIt = Module.findBlocksAt(AlignInfo.EA); !BlockIt.empty())
+        if(gtirb::Node *Block = Index.findBlockAt(AlignInfo.EA))
         {
-            gtirb::Node &Block = BlockIt.front();
-            (*Alignment)[Block.getUUID()] = AlignInfo.Num;
+            (*Alignment)[Block->getUUID()] = AlignInfo.Num;
         }
     }
 }
@@ -1066,39 +1342,18 @@ void buildFunctions(gtirb::Module &Module, souffle::SouffleProgram &Program)
     Module.addAuxData<gtirb::schema::FunctionNames>(std::move(FunctionNames));
 }
 
-gtirb::EdgeType getEdgeType(const std::string &type)
-{
-    if(type == "branch")
-        return gtirb::EdgeType::Branch;
-    if(type == "call")
-        return gtirb::EdgeType::Call;
-    if(type == "return")
-        return gtirb::EdgeType::Return;
-    // TODO syscall and sysret
-    return gtirb::EdgeType::Fallthrough;
-}
-
-void buildCFG(gtirb::Context &Context, gtirb::Module &Module, souffle::SouffleProgram &Program)
+void buildCFG(gtirb::Context &Context, gtirb::Module &Module, const ModuleIndex &Index,
+              const OutputRelations &Relations, souffle::SouffleProgram &Program)
 {
     auto &Cfg = Module.getIR()->getCFG();
-    for(auto &Output : *Program.getRelation("cfg_edge"))
+    for(const CfgEdge &Edge : Relations.CfgEdges)
     {
-        gtirb::Addr SrcAddr, DestAddr;
-        std::string Conditional, Indirect, Type;
-        Output >> SrcAddr >> DestAddr >> Conditional >> Indirect >> Type;
-
         // ddisasm guarantees that these blocks exist
-        const gtirb::CodeBlock *Src = &*Module.findCodeBlocksOn(SrcAddr).begin();
-        const gtirb::CodeBlock *Dest = &*Module.findCodeBlocksOn(DestAddr).begin();
-
-        auto IsConditional = Conditional == "true" ? gtirb::ConditionalEdge::OnTrue
-                                                   : gtirb::ConditionalEdge::OnFalse;
-        auto IsIndirect =
-            Indirect == "true" ? gtirb::DirectEdge::IsIndirect : gtirb::DirectEdge::IsDirect;
-        gtirb::EdgeType edgeType = getEdgeType(Type);
+        const gtirb::CodeBlock *Src = Index.findCodeBlockOn(Edge.Src);
+        const gtirb::CodeBlock *Dest = Index.findCodeBlockOn(Edge.Dest);
 
         auto E = addEdge(Src, Dest, Cfg);
-        Cfg[*E] = std::make_tuple(IsConditional, IsIndirect, edgeType);
+        Cfg[*E] = std::make_tuple(Edge.IsConditional, Edge.IsIndirect, Edge.EdgeType);
     }
     auto *TopBlock = Module.addProxyBlock(Context);
     for(auto &Output : *Program.getRelation("cfg_edge_to_top"))
@@ -1106,7 +1361,7 @@ void buildCFG(gtirb::Context &Context, gtirb::Module &Module, souffle::SoufflePr
         gtirb::Addr SrcAddr;
         std::string Conditional, Type;
         Output >> SrcAddr >> Conditional >> Type;
-        const gtirb::CodeBlock *Src = &*Module.findCodeBlocksOn(SrcAddr).begin();
+        const gtirb::CodeBlock *Src = Index.findCodeBlockOn(SrcAddr);
         auto isConditional = Conditional == "true" ? gtirb::ConditionalEdge::OnTrue
                                                    : gtirb::ConditionalEdge::OnFalse;
         gtirb::EdgeType EdgeType = getEdgeType(Type);
@@ -1120,7 +1375,7 @@ void buildCFG(gtirb::Context &Context, gtirb::Module &Module, souffle::SoufflePr
         std::string Conditional, Indirect, Type;
         T >> EA >> Name >> Conditional >> Indirect >> Type;
 
-        const gtirb::CodeBlock *CodeBlock = &*Module.findCodeBlocksOn(EA).begin();
+        const gtirb::CodeBlock *CodeBlock = Index.findCodeBlockOn(EA);
         auto It = Module.findSymbols(Name);
         if(It.empty())
         {
@@ -1178,35 +1433,48 @@ std::vector<gtirb::Offset> findOffsets(gtirb::Module &module, gtirb::Addr ea)
     return offsets;
 }
 
-void updateComment(gtirb::Module &module, std::map<gtirb::Offset, std::string> &comments,
-                   gtirb::Addr ea, std::string newComment)
+// The comments are collected in order, and the comments of the same offset
+// are joined by mergeComments once all of them are known.
+void updateComment(gtirb::Module &module,
+                   std::vector<std::pair<gtirb::Offset, std::string>> &comments, gtirb::Addr ea,
+                   std::string newComment)
 {
-    std::vector<gtirb::Offset> matchingOffsets = findOffsets(module, ea);
-    for(gtirb::Offset &offset : matchingOffsets)
+    for(gtirb::Offset &offset : findOffsets(module, ea))
     {
-        auto existing = comments.find(offset);
-        if(existing != comments.end())
+        comments.emplace_back(offset, newComment);
+    }
+}
+
+std::map<gtirb::Offset, std::string> mergeComments(
+    std::vector<std::pair<gtirb::Offset, std::string>> &&Comments)
+{
+    std::stable_sort(Comments.begin(), Comments.end(),
+                     [](const auto &A, const auto &B) { return A.first < B.first; });
+    std::map<gtirb::Offset, std::string> Result;
+    for(auto &[Offset, Comment] : Comments)
+    {
+        if(!Result.empty() && std::prev(Result.end())->first == Offset)
         {
-            existing->second += ", ";
-            existing->second += newComment;
+            std::string &Existing = std::prev(Result.end())->second;
+            Existing += ", ";
+            Existing += Comment;
         }
         else
-            comments[offset] = newComment;
+        {
+            Result.emplace_hint(Result.end(), Offset, std::move(Comment));
+        }
     }
+    return Result;
 }
 
-void buildCfiDirectives(gtirb::Module &Module, souffle::SouffleProgram &Program)
+void buildCfiDirectives(gtirb::Module &Module, const OutputRelations &Relations)
 {
     std::map<gtirb::Offset, std::vector<std::tuple<std::string, std::vector<int64_t>, gtirb::UUID>>>
         CfiDirectives;
-    for(auto &output : *Program.getRelation("cfi_directive"))
-    {
-        gtirb::Addr BlockAddr;
-        std::string Directive, Reference;
-        uint64_t Disp, LocalIndex, NumOperands;
-        int64_t Op1, Op2;
-        output >> BlockAddr >> Disp >> LocalIndex >> Directive >> Reference >> NumOperands >> Op1
-            >> Op2;
+    for(const CfiDirective &Cfi : Relations.CfiDirectives)
+    {
+        const auto &[BlockAddr, Disp, LocalIndex, Directive, Reference, NumOperands, Op1, Op2] =
+            Cfi;
         std::vector<int64_t> Operands;
         // cfi_escape directives have a sequence of bytes as operands (the raw bytes of the
         // dwarf instruction). The address 'Reference' points to these bytes.
@@ -1283,14 +1551,11 @@ void buildSehTable(gtirb::Module &Module, souffle::SouffleProgram &Program)
     Module.addAuxData<gtirb::schema::PeSafeExceptionHandlers>(std::move(Handlers));
 }
 
-void buildPadding(gtirb::Module &Module, souffle::SouffleProgram &Program)
+void buildPadding(gtirb::Module &Module, const OutputRelations &Relations)
 {
     std::map<gtirb::Offset, uint64_t> Padding;
-    for(auto &Output : *Program.getRelation("padding"))
+    for(auto &[EA, Size] : Relations.Padding)
     {
-        gtirb::Addr EA;
-        uint64_t Size;
-        Output >> EA >> Size;
         if(auto It = Module.findByteIntervalsOn(EA); !It.empty())
         {
             if(gtirb::ByteInterval &ByteInterval = *It.begin(); ByteInterval.getAddress())
@@ -1306,7 +1571,19 @@ void buildPadding(gtirb::Module &Module, souffle::SouffleProgram &Program)
 
 void buildComments(gtirb::Module &Module, souffle::SouffleProgram &Program, bool SelfDiagnose)
 {
-    std::map<gtirb::Offset, std::string> Comments;
+    std::vector<std::pair<gtirb::Offset, std::string>> Comments;
+    size_t ExpectedComments = 0;
+    for(const char *Name :
+        {"data_access_pattern", "preferred_data_access", "best_value_reg", "value_reg",
+         "moved_label_class", "reg_def_use.def_used", "missed_jump_table", "reg_has_base_image",
+         "reg_has_got", "false_positive", "false_negative", "bad_symbol_constant"})
+    {
+        if(souffle::Relation *Relation = Program.getRelation(Name))
+        {
+            ExpectedComments += Relation->size();
+        }
+    }
+    Comments.reserve(ExpectedComments);
     auto *data_access_pattern = Program.getRelation("data_access_pattern");
     if(data_access_pattern)
     {
@@ -1465,7 +1742,7 @@ void buildComments(gtirb::Module &Module, souffle::SouffleProgram &Program, bool
             updateComment(Module, Comments, Ea, NewComment.str());
         }
     }
-    Module.addAuxData<gtirb::schema::Comments>(std::move(Comments));
+    Module.addAuxData<gtirb::schema::Comments>(mergeComments(std::move(Comments)));
 }
 
 void updateEntryPoint(gtirb::Module &module, souffle::SouffleProgram &Program)
@@ -1622,27 +1899,69 @@ void removePreviousModuleContent(gtirb::Module &Module)
         }
     }
 }
+// Release the storage of relations that are not read anymore.
+void purgeRelations(souffle::SouffleProgram &Program, const std::vector<std::string> &Names)
+{
+    for(const std::string &Name : Names)
+    {
+        if(souffle::Relation *Relation = Program.getRelation(Name))
+        {
+            Relation->purge();
+        }
+    }
+}
+
 void disassembleModule(gtirb::Context &Context, gtirb::Module &Module,
-                       souffle::SouffleProgram &Program, bool SelfDiagnose)
+                       souffle::SouffleProgram &Program, bool SelfDiagnose, const Executor &Exec,
+                       bool ReleaseRelations)
 {
+    auto Release = [&](const std::vector<std::string> &Names) {
+        if(ReleaseRelations)
+        {
+            purgeRelations(Program, Names);
+        }
+    };
+
+    OutputRelations Relations = extractOutputRelations(Program, Exec);
+    Release({"code_in_refined_block", "block_information", "symbolic_expr",
+             "symbolic_expr_symbol_minus_symbol", "symbolic_expr_attribute", "string",
+             "symbol_special_encoding", "data_object_boundary", "bss_data", "alignment",
+             "cfg_edge", "cfi_directive", "padding"});
+    if(ReleaseRelations)
+    {
+        // The loader facts (instruction, op_*, address_in_data, ...) are the
+        // largest relations; only the entry point is read after this point.
+        for(souffle::Relation *Relation : Program.getInputRelations())
+        {
+            if(Relation->getName() != "entry_point")
+            {
+                Relation->purge();
+            }
+        }
+    }
+
     removeSectionSymbols(Context, Module);
     removeEntryPoint(Module);
     removePreviousModuleContent(Module);
     buildInferredSymbols(Context, Module, Program);
     buildSymbolForwarding(Context, Module, Program);
-    buildCodeBlocks(Context, Module, Program);
-    buildDataBlocks(Context, Module, Program);
-    buildAlignments(Module, Program);
-    buildCodeSymbolicInformation(Module, Program);
-    buildCfiDirectives(Module, Program);
+    ModuleIndex Index(Module);
+    buildCodeBlocks(Context, Module, Index, Relations, Program);
+    Release({"refined_block"});
+    buildDataBlocks(Context, Module, Index, Relations, Program);
+    Release({"initialized_data_segment", "bss_section"});
+    buildAlignments(Module, Index, Relations);
+    buildCodeSymbolicInformation(Module, Index, Relations);
+    buildCfiDirectives(Module, Relations);
     buildSehTable(Module, Program);
     expandSymbolForwarding(Module, Program);
     buildFunctions(Module, Program);
     // This should be done after creating all the symbols.
     connectSymbolsToBlocks(Context, Module, Program);
     // These functions should not create additional symbols.
-    buildCFG(Context, Module, Program);
-    buildPadding(Module, Program);
+    buildCFG(Context, Module, Index, Relations, Program);
+    Release({"cfg_edge_to_top", "cfg_edge_to_symbol"});
+    buildPadding(Module, Relations);
     buildComments(Module, Program, SelfDiagnose);
     buildDynamicAuxdata(Module);
     updateEntryPoint(Module, Program);
@@ -26,10 +26,18 @@
 
 #include <gtirb/gtirb.hpp>
 
+#include "../gtirb-decoder/Executor.h"
 #include "AnalysisPass.h"
 
+/**
+Build the module from the disassembly results, extracting the relations with
+Exec. If ReleaseRelations is set, the storage of the relations is released as
+soon as they have been consumed.
+*/
 void disassembleModule(gtirb::Context &context, gtirb::Module &module,
-                       souffle::SouffleProgram &Program, bool selfDiagnose);
+                       souffle::SouffleProgram &Program, bool selfDiagnose,
+                       const Executor &Exec = Executor::sequential(),
+                       bool ReleaseRelations = false);
 void performSanityChecks(AnalysisPassResult &Result, souffle::SouffleProgram &Program,
                          bool selfDiagnose, bool ignoreErrors);
 
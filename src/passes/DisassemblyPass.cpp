@@ -22,6 +22,13 @@
 //===----------------------------------------------------------------------===//
 #include "DisassemblyPass.h"
 
+#if defined(DDISASM_DATALOG_PLUGINS)
+#include <dlfcn.h>
+
+#include <boost/dll.hpp>
+#include <cstdlib>
+#endif
+
 #include "../gtirb-decoder/CompositeLoader.h"
 #include "../gtirb-decoder/Relations.h"
 #include "../gtirb-decoder/core/ModuleLoader.h"
@@ -33,6 +40,46 @@ std::map<DisassemblyPass::Target, DisassemblyPass::Factory>& DisassemblyPass::lo
     return Loaders;
 }
 
+#if defined(DDISASM_DATALOG_PLUGINS)
+bool DisassemblyPass::loadPlugin(const std::string& ProgramName, std::string& Error)
+{
+    // The program "souffle_disasm_<arch>" is in libddisasm_datalog_<arch>.so,
+    // and registers itself with the souffle::ProgramFactory when it is loaded.
+    const std::string Prefix = "souffle_disasm_";
+    std::string Arch = ProgramName.substr(ProgramName.find(Prefix) == 0 ? Prefix.size() : 0);
+    std::string Filename = "libddisasm_datalog_" + Arch + ".so";
+
+    // The plugins are in `lib/ddisasm' next to the `bin' directory of ddisasm
+    // in the build and install trees, and in `.libs' in the python package.
+    std::vector<fs::path> Directories;
+    if(const char* Dir = std::getenv("DDISASM_PLUGIN_DIR"))
+    {
+        Directories.push_back(Dir);
+    }
+    fs::path Bin = boost::dll::program_location().parent_path();
+    Directories.push_back(Bin / ".." / "lib" / "ddisasm");
+    Directories.push_back(Bin / ".libs");
+
+    for(const fs::path& Directory : Directories)
+    {
+        fs::path Path = Directory / Filename;
+        if(!fs::exists(Path))
+        {
+            continue;
+        }
+        // The plugin is never unloaded: the factory stays registered until exit.
+        if(!dlopen(Path.string().c_str(), RTLD_NOW | RTLD_LOCAL))
+        {
+            Error = dlerror();
+            return false;
+        }
+        return true;
+    }
+    Error = Filename + " not found";
+    return false;
+}
+#endif
+
 void DisassemblyPass::loadImpl(AnalysisPassResult& Result, const gtirb::Context& Context,
                                const gtirb::Module& Module, AnalysisPass* PreviousPass)
 {
@@ -41,7 +88,57 @@ void DisassemblyPass::loadImpl(AnalysisPassResult& Result, const gtirb::Context&
     if(auto It = Factories.find(Target); It != Factories.end())
     {
         auto Loader = (It->second)();
-        Program = Loader.load(Module);
+        if(NoCfiDirectives)
+        {
+            Loader.addOption("no-cfi-directives");
+        }
+        if(TrustRelocations)
+        {
+            // The relocation-based symbolization only knows the x86-64
+            // relocation types and operand offsets.
+            if(Module.getISA() == gtirb::ISA::X64)
+            {
+                Loader.addOption("trust-relocations");
+            }
+            else
+            {
+                Result.Warnings.push_back(Module.getName()
+                                          + ": --trust-relocations is only supported for "
+                                            "x86-64, it is ignored for "
+                                          + binaryISA(Module.getISA()));
+            }
+        }
+        if(PruneSuperset)
+        {
+            Loader.addOption("prune-superset");
+        }
+        Program = Loader.load(Module, getExecutor());
+#if defined(DDISASM_DATALOG_PLUGINS)
+        // Unless it is linked in (e.g. in the tests), the program is only
+        // registered once its plugin is loaded.
+        if(!Program)
+        {
+            std::string Error = "program not found in plugin";
+            if(loadPlugin(Loader.getName(), Error))
+            {
+                Program = Loader.load(Module, getExecutor());
+            }
+            if(!Program)
+            {
+                Result.Errors.push_back(Module.getName() + ": failed to load the Datalog program "
+                                        + Loader.getName() + ": " + Error);
+                return;
+            }
+        }
+#endif
+
+        Budget = analysisBudget(Module);
+        std::vector<relations::AnalysisBudget> Limits;
+        for(auto& [Name, Limit] : Budget)
+        {
+            Limits.push_back({Name, Limit});
+        }
+        relations::insert(*Program, "analysis_budget", Limits);
     }
     else
     {
@@ -59,13 +156,43 @@ void DisassemblyPass::loadImpl(AnalysisPassResult& Result, const gtirb::Context&
         }
         Result.Errors.push_back(StrBuilder.str());
     }
+}
+
+bool DisassemblyPass::isAnalysisBudget(const std::string& Level)
+{
+    return Level == "auto" || Level == "low" || Level == "normal" || Level == "high";
+}
+
+std::map<std::string, uint64_t> DisassemblyPass::analysisBudget(const gtirb::Module& Module) const
+{
+    // Bounds of the "normal" level.
+    std::map<std::string, uint64_t> Limits = {{"step_limit", 12}, {"step_limit_small", 3}};
+
+    std::string Level = AnalysisBudget;
+    if(Level == "auto")
+    {
+        // Value propagation dominates the runtime of very large binaries.
+        const uint64_t LargeCodeSize = 32 * 1024 * 1024;
+        uint64_t CodeSize = 0;
+        for(const auto& Section : Module.sections())
+        {
+            if(Section.isFlagSet(gtirb::SectionFlag::Executable))
+            {
+                CodeSize += Section.getSize().value_or(0);
+            }
+        }
+        Level = CodeSize > LargeCodeSize ? "low" : "normal";
+    }
 
-    if(NoCfiDirectives)
+    if(Level == "low")
     {
-        std::vector<std::string> Options;
-        Options.push_back("no-cfi-directives");
-        relations::insert(*Program, "option", Options);
+        Limits = {{"step_limit", 8}, {"step_limit_small", 2}};
     }
+    else if(Level == "high")
+    {
+        Limits = {{"step_limit", 16}, {"step_limit_small", 4}};
+    }
+    return Limits;
 }
 
 void DisassemblyPass::transformImpl(AnalysisPassResult& Result, gtirb::Context& Context,
@@ -73,6 +200,9 @@ void DisassemblyPass::transformImpl(AnalysisPassResult& Result, gtirb::Context&
 {
     DatalogAnalysisPass::transformImpl(Result, Context, Module);
 
-    disassembleModule(Context, Module, *Program, SelfDiagnose);
+    Module.addAuxData<gtirb::schema::AnalysisBudget>(std::map<std::string, uint64_t>(Budget));
+
+    // Keep the relations in the same cases as intermediate relations are kept.
+    disassembleModule(Context, Module, *Program, SelfDiagnose, getExecutor(), !keepRelations());
     performSanityChecks(Result, *Program, SelfDiagnose, IgnoreErrors);
 }
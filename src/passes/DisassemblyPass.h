@@ -29,8 +29,14 @@ class DisassemblyPass : public DatalogAnalysisPass
 {
 public:
     DisassemblyPass(bool SelfDiagnose = false, bool IgnoreErrors = false,
-                    bool NoCfiDirectives = false)
-        : SelfDiagnose(SelfDiagnose), IgnoreErrors(IgnoreErrors), NoCfiDirectives(NoCfiDirectives)
+                    bool NoCfiDirectives = false, bool TrustRelocations = false,
+                    bool PruneSuperset = false, const std::string& AnalysisBudget = "auto")
+        : SelfDiagnose(SelfDiagnose),
+          IgnoreErrors(IgnoreErrors),
+          NoCfiDirectives(NoCfiDirectives),
+          TrustRelocations(TrustRelocations),
+          PruneSuperset(PruneSuperset),
+          AnalysisBudget(AnalysisBudget)
     {
     }
 
@@ -53,6 +59,25 @@ public:
         loaders()[T] = F;
     }
 
+    // Budget levels accepted by the constructor: "auto", "low", "normal" or "high".
+    static bool isAnalysisBudget(const std::string& Level);
+
+    // Use the "low" analysis budget first, and then prune the superset of instructions.
+    virtual std::optional<std::string> reduceCost() override
+    {
+        if(AnalysisBudget != "low")
+        {
+            AnalysisBudget = "low";
+            return "analysis-budget-low";
+        }
+        if(!PruneSuperset)
+        {
+            PruneSuperset = true;
+            return "prune-superset";
+        }
+        return std::nullopt;
+    }
+
 protected:
     virtual std::string getSourceFilename() const override
     {
@@ -64,12 +89,24 @@ protected:
     void transformImpl(AnalysisPassResult& Result, gtirb::Context& Context,
                        gtirb::Module& Module) override;
 
+    // Choose the analysis bounds (e.g. `step_limit`) for the budget level and module size.
+    std::map<std::string, uint64_t> analysisBudget(const gtirb::Module& Module) const;
+
 private:
     bool SelfDiagnose = false;
     bool IgnoreErrors = false;
     bool NoCfiDirectives = false;
+    bool TrustRelocations = false;
+    bool PruneSuperset = false;
+    std::string AnalysisBudget = "auto";
+    std::map<std::string, uint64_t> Budget;
 
     static std::map<Target, Factory>& loaders();
+
+#if defined(DDISASM_DATALOG_PLUGINS)
+    // Load the plugin of a Datalog program; it registers the program on load.
+    static bool loadPlugin(const std::string& ProgramName, std::string& Error);
+#endif
 };
 
 #endif // SYMBOLIZATION_PASS_H_
@@ -22,6 +22,7 @@
 //===----------------------------------------------------------------------===//
 #include "FunctionInferencePass.h"
 
+#include <algorithm>
 #include <boost/uuid/uuid_generators.hpp>
 
 #include "../AuxDataSchema.h"
@@ -32,6 +33,61 @@
 #include "../gtirb-decoder/core/InstructionLoader.h"
 #include "../gtirb-decoder/core/SymbolicExpressionLoader.h"
 
+// Module elements sorted by address. The relation outputs are joined with
+// these instead of querying the module for every tuple.
+template <typename T>
+using AddressIndex = std::vector<std::pair<gtirb::Addr, T*>>;
+
+template <typename T, typename Range>
+AddressIndex<T> buildAddressIndex(Range&& Elements)
+{
+    AddressIndex<T> Index;
+    for(T& Element : Elements)
+    {
+        if(std::optional<gtirb::Addr> Addr = Element.getAddress())
+        {
+            Index.emplace_back(*Addr, &Element);
+        }
+    }
+    std::stable_sort(Index.begin(), Index.end(),
+                     [](const auto& A, const auto& B) { return A.first < B.first; });
+    return Index;
+}
+
+// Entries of Index at address Addr, searching from From onwards.
+template <typename T>
+std::pair<typename AddressIndex<T>::const_iterator, typename AddressIndex<T>::const_iterator>
+findAt(const AddressIndex<T>& Index, typename AddressIndex<T>::const_iterator From,
+       gtirb::Addr Addr)
+{
+    auto Begin = std::lower_bound(From, Index.end(), Addr,
+                                  [](const auto& Entry, gtirb::Addr A) { return Entry.first < A; });
+    auto End = Begin;
+    while(End != Index.end() && End->first == Addr)
+    {
+        End++;
+    }
+    return {Begin, End};
+}
+
+// Convert (key, value) pairs to the map of sets used by the AuxData tables.
+std::map<gtirb::UUID, std::set<gtirb::UUID>> groupByKey(
+    std::vector<std::pair<gtirb::UUID, gtirb::UUID>>& Pairs)
+{
+    std::sort(Pairs.begin(), Pairs.end());
+    std::map<gtirb::UUID, std::set<gtirb::UUID>> Result;
+    auto Group = Result.end();
+    for(const auto& [Key, Value] : Pairs)
+    {
+        if(Group == Result.end() || Group->first != Key)
+        {
+            Group = Result.emplace_hint(Result.end(), Key, std::set<gtirb::UUID>());
+        }
+        Group->second.emplace_hint(Group->second.end(), Value);
+    }
+    return Result;
+}
+
 void FunctionInferencePass::transformImpl(AnalysisPassResult& Result, gtirb::Context& Context,
                                           gtirb::Module& Module)
 {
@@ -39,106 +95,144 @@ void FunctionInferencePass::transformImpl(AnalysisPassResult& Result, gtirb::Con
 
     auto* SymbolInfo = Module.getAuxData<gtirb::schema::ElfSymbolInfo>();
 
-    std::map<gtirb::UUID, std::set<gtirb::UUID>> FunctionEntries;
-    std::map<gtirb::Addr, gtirb::UUID> FunctionEntry2function;
-    std::map<gtirb::UUID, gtirb::UUID> FunctionNames;
-    boost::uuids::random_generator Generator;
+    AddressIndex<gtirb::CodeBlock> Blocks =
+        buildAddressIndex<gtirb::CodeBlock>(Module.code_blocks());
+    // symbols_by_addr() is the index that findSymbols(Addr) searches, so the
+    // symbols at each address keep the order that breaks ties below.
+    AddressIndex<gtirb::Symbol> Symbols =
+        buildAddressIndex<gtirb::Symbol>(Module.symbols_by_addr());
+
+    std::vector<gtirb::Addr> Entries;
     for(auto& Output : *Program->getRelation("function_entry_final"))
     {
-        gtirb::Addr FunctionEntry(Output[0]);
-        auto BlockRange = Module.findCodeBlocksAt(FunctionEntry);
-        if(!BlockRange.empty())
+        Entries.emplace_back(Output[0]);
+    }
+    std::sort(Entries.begin(), Entries.end());
+    Entries.erase(std::unique(Entries.begin(), Entries.end()), Entries.end());
+
+    std::vector<std::pair<gtirb::UUID, gtirb::UUID>> FunctionEntries;
+    // Sorted by address, as Entries.
+    std::vector<std::pair<gtirb::Addr, gtirb::UUID>> FunctionEntry2function;
+    std::vector<std::pair<gtirb::UUID, gtirb::UUID>> FunctionNames;
+    FunctionEntries.reserve(Entries.size());
+    FunctionEntry2function.reserve(Entries.size());
+    FunctionNames.reserve(Entries.size());
+    boost::uuids::random_generator Generator;
+    auto BlockIt = Blocks.cbegin();
+    auto SymbolIt = Symbols.cbegin();
+    for(gtirb::Addr FunctionEntry : Entries)
+    {
+        auto [FirstBlock, LastBlock] = findAt(Blocks, BlockIt, FunctionEntry);
+        BlockIt = FirstBlock;
+        if(FirstBlock == LastBlock)
         {
-            const gtirb::UUID& EntryBlockUUID = BlockRange.begin()->getUUID();
-            gtirb::UUID FunctionUUID = Generator();
-            FunctionEntry2function[FunctionEntry] = FunctionUUID;
-            FunctionEntries[FunctionUUID].insert(EntryBlockUUID);
+            continue;
+        }
+        gtirb::CodeBlock* EntryBlock = FirstBlock->second;
+        gtirb::UUID FunctionUUID = Generator();
+        FunctionEntry2function.emplace_back(FunctionEntry, FunctionUUID);
+        FunctionEntries.emplace_back(FunctionUUID, EntryBlock->getUUID());
 
-            auto It = Module.findSymbols(FunctionEntry);
-            if(It.empty())
-            {
-                // Create a new label for the function entry.
-                std::stringstream Label;
-                Label << ".L_" << std::hex << static_cast<uint64_t>(FunctionEntry);
-                gtirb::Symbol* Symbol = Module.addSymbol(Context, FunctionEntry, Label.str());
-
-                // Map function to symbol and create new symbol information.
-                FunctionNames.insert({FunctionUUID, Symbol->getUUID()});
-                if(SymbolInfo)
-                {
-                    auxdata::ElfSymbolInfo Info = {0, "FUNC", "LOCAL", "DEFAULT", 0};
-                    SymbolInfo->insert({Symbol->getUUID(), Info});
-                }
+        auto [FirstSymbol, LastSymbol] = findAt(Symbols, SymbolIt, FunctionEntry);
+        SymbolIt = FirstSymbol;
+        if(FirstSymbol == LastSymbol)
+        {
+            // Create a new label for the function entry.
+            std::stringstream Label;
+            Label << ".L_" << std::hex << static_cast<uint64_t>(FunctionEntry);
+            gtirb::Symbol* Symbol = Module.addSymbol(Context, FunctionEntry, Label.str());
 
-                // Connect new symbol to the code-block.
-                if(auto Found = Module.findCodeBlocksAt(FunctionEntry); !Found.empty())
-                {
-                    gtirb::CodeBlock& CodeBlock = Found.front();
-                    Symbol->setReferent(&CodeBlock);
-                }
+            // Map function to symbol and create new symbol information.
+            FunctionNames.emplace_back(FunctionUUID, Symbol->getUUID());
+            if(SymbolInfo)
+            {
+                auxdata::ElfSymbolInfo Info = {0, "FUNC", "LOCAL", "DEFAULT", 0};
+                SymbolInfo->insert({Symbol->getUUID(), Info});
             }
-            else if(SymbolInfo)
+
+            // Connect new symbol to the code-block.
+            Symbol->setReferent(EntryBlock);
+        }
+        else if(SymbolInfo)
+        {
+            // Aggregate candidate symbols.
+            std::vector<std::tuple<const gtirb::Symbol*, std::string, std::string>> Candidates;
+            for(auto It = FirstSymbol; It != LastSymbol; It++)
             {
-                // Aggregate candidate symbols.
-                std::vector<std::tuple<const gtirb::Symbol*, std::string, std::string>> Candidates;
-                for(auto& Symbol : It)
+                const gtirb::Symbol& Symbol = *It->second;
+                if(const auto& Found = SymbolInfo->find(Symbol.getUUID());
+                   Found != SymbolInfo->end())
                 {
-                    if(const auto& Found = SymbolInfo->find(Symbol.getUUID());
-                       Found != SymbolInfo->end())
-                    {
-                        std::string& Type = std::get<1>(Found->second);
-                        std::string& Binding = std::get<2>(Found->second);
-                        Candidates.push_back({&Symbol, Type, Binding});
-                    }
+                    std::string& Type = std::get<1>(Found->second);
+                    std::string& Binding = std::get<2>(Found->second);
+                    Candidates.push_back({&Symbol, Type, Binding});
                 }
-                // Select best candidate symbols.
-                auto Found = std::min_element(
-                    Candidates.begin(), Candidates.end(),
-                    [](const std::tuple<const gtirb::Symbol*, std::string, std::string>& S1,
-                       const std::tuple<const gtirb::Symbol*, std::string, std::string>& S2) {
-                        auto& [Symbol1, Type1, Binding1] = S1;
-                        auto& [Symbol2, Type2, Binding2] = S2;
-                        // Prefer symbols of type FUNC.
-                        if(Type1 == "FUNC" && Type2 != "FUNC")
-                            return true;
-                        // Prefer GLOBAL FUNC symbols to LOCAL FUNC symbols.
-                        if(Binding1 == "GLOBAL" && Binding2 != "GLOBAL")
-                            return true;
-                        // Prefer symbols without underscore prefixes.
-                        const std::string &Name1 = Symbol1->getName(), &Name2 = Symbol2->getName();
-                        if(Name1.substr(0, 1) != "_" && Name2.substr(0, 1) == "_")
-                            return true;
-                        return false;
-                    });
-                assert(Found != Candidates.end() && "Expected candidate function symbols.");
-                FunctionNames.insert({FunctionUUID, std::get<0>(*Found)->getUUID()});
-            }
-            else
-            {
-                // Use an arbitrary symbol at this address as the function label.
-                gtirb::Symbol* Symbol = &*It.begin();
-                FunctionNames.insert({FunctionUUID, Symbol->getUUID()});
             }
+            // Select best candidate symbols.
+            auto Found = std::min_element(
+                Candidates.begin(), Candidates.end(),
+                [](const std::tuple<const gtirb::Symbol*, std::string, std::string>& S1,
+                   const std::tuple<const gtirb::Symbol*, std::string, std::string>& S2) {
+                    auto& [Symbol1, Type1, Binding1] = S1;
+                    auto& [Symbol2, Type2, Binding2] = S2;
+                    // Prefer symbols of type FUNC.
+                    if(Type1 == "FUNC" && Type2 != "FUNC")
+                        return true;
+                    // Prefer GLOBAL FUNC symbols to LOCAL FUNC symbols.
+                    if(Binding1 == "GLOBAL" && Binding2 != "GLOBAL")
+                        return true;
+                    // Prefer symbols without underscore prefixes.
+                    const std::string &Name1 = Symbol1->getName(), &Name2 = Symbol2->getName();
+                    if(Name1.substr(0, 1) != "_" && Name2.substr(0, 1) == "_")
+                        return true;
+                    return false;
+                });
+            assert(Found != Candidates.end() && "Expected candidate function symbols.");
+            FunctionNames.emplace_back(FunctionUUID, std::get<0>(*Found)->getUUID());
+        }
+        else
+        {
+            // Use an arbitrary symbol at this address as the function label.
+            FunctionNames.emplace_back(FunctionUUID, FirstSymbol->second->getUUID());
         }
     }
-    std::map<gtirb::UUID, std::set<gtirb::UUID>> FunctionBlocks;
+
+    std::vector<std::pair<gtirb::UUID, gtirb::UUID>> FunctionBlocks;
     for(auto& Output : *Program->getRelation("in_function_final"))
     {
         gtirb::Addr BlockAddr(Output[0]), FunctionEntryAddr(Output[1]);
-        auto BlockRange = Module.findCodeBlocksOn(BlockAddr);
-        if(!BlockRange.empty())
+        gtirb::CodeBlock* Block = nullptr;
+        if(auto [First, Last] = findAt(Blocks, Blocks.cbegin(), BlockAddr); First != Last)
+        {
+            Block = First->second;
+        }
+        else if(auto BlockRange = Module.findCodeBlocksOn(BlockAddr); !BlockRange.empty())
+        {
+            Block = &*BlockRange.begin();
+        }
+        if(Block)
         {
-            gtirb::CodeBlock* Block = &*BlockRange.begin();
-            gtirb::UUID FunctionEntryUUID = FunctionEntry2function[FunctionEntryAddr];
-            FunctionBlocks[FunctionEntryUUID].insert(Block->getUUID());
+            // Blocks of unknown functions are grouped under the nil UUID.
+            gtirb::UUID FunctionEntryUUID;
+            auto Function = std::lower_bound(
+                FunctionEntry2function.begin(), FunctionEntry2function.end(), FunctionEntryAddr,
+                [](const auto& Entry, gtirb::Addr A) { return Entry.first < A; });
+            if(Function != FunctionEntry2function.end() && Function->first == FunctionEntryAddr)
+            {
+                FunctionEntryUUID = Function->second;
+            }
+            FunctionBlocks.emplace_back(FunctionEntryUUID, Block->getUUID());
         }
     }
+
+    std::sort(FunctionNames.begin(), FunctionNames.end());
     Module.removeAuxData<gtirb::schema::FunctionEntries>();
     Module.removeAuxData<gtirb::schema::FunctionBlocks>();
     Module.removeAuxData<gtirb::schema::FunctionNames>();
-    Module.addAuxData<gtirb::schema::FunctionEntries>(std::move(FunctionEntries));
-    Module.addAuxData<gtirb::schema::FunctionBlocks>(std::move(FunctionBlocks));
-    Module.addAuxData<gtirb::schema::FunctionNames>(std::move(FunctionNames));
+    Module.addAuxData<gtirb::schema::FunctionEntries>(groupByKey(FunctionEntries));
+    Module.addAuxData<gtirb::schema::FunctionBlocks>(groupByKey(FunctionBlocks));
+    Module.addAuxData<gtirb::schema::FunctionNames>(
+        std::map<gtirb::UUID, gtirb::UUID>(FunctionNames.begin(), FunctionNames.end()));
 }
 
 void FunctionInferencePass::loadImpl(AnalysisPassResult& Result, const gtirb::Context& Context,
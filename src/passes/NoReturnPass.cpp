@@ -26,32 +26,25 @@
 #include "../gtirb-decoder/Relations.h"
 #include "../gtirb-decoder/core/AuxDataLoader.h"
 #include "../gtirb-decoder/core/EdgesLoader.h"
+#include "CfgPatch.h"
 
 void NoReturnPass::transformImpl(AnalysisPassResult& Result, gtirb::Context& Context,
                                  gtirb::Module& Module)
 {
     DatalogAnalysisPass::transformImpl(Result, Context, Module);
 
-    std::set<gtirb::CodeBlock*> NoReturn;
+    // Only the fallthrough edges of the no-return calls are removed.
+    CfgPatch Patch;
     for(auto& Output : *Program->getRelation("block_call_no_return"))
     {
         gtirb::Addr BlockAddr(Output[0]);
         // this should correspond to only one block
         for(auto& Block : Module.findCodeBlocksOn(BlockAddr))
         {
-            NoReturn.insert(&Block);
+            Patch.removeOutEdges(&Block, gtirb::EdgeType::Fallthrough);
         }
     }
-    gtirb::CFG& Cfg = Module.getIR()->getCFG();
-    boost::remove_edge_if(
-        [&](auto Edge) {
-            gtirb::EdgeLabel Label = *static_cast<const gtirb::EdgeLabel*>(Edge.get_property());
-            if(auto* Block = gtirb::dyn_cast<gtirb::CodeBlock>(Cfg[Edge.m_source]))
-                return NoReturn.count(Block) && Label
-                       && std::get<gtirb::EdgeType>(*Label) == gtirb::EdgeType::Fallthrough;
-            return false;
-        },
-        Cfg);
+    Patch.apply(Module.getIR()->getCFG());
 }
 
 void NoReturnPass::loadImpl(AnalysisPassResult& Result, const gtirb::Context& Context,
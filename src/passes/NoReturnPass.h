@@ -52,6 +52,11 @@ class NoReturnPass : public DatalogAnalysisPass
         return true;
     }
 
+    virtual bool isOptional() const override
+    {
+        return true;
+    }
+
 protected:
     void loadImpl(AnalysisPassResult& Result, const gtirb::Context& Context,
                   const gtirb::Module& Module, AnalysisPass* PreviousPass = nullptr) override;
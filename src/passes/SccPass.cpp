@@ -24,9 +24,10 @@
 
 #include <boost/config.hpp>
 #include <boost/graph/adjacency_list.hpp>
-#include <boost/graph/filtered_graph.hpp>
 #include <boost/graph/graph_utility.hpp>
-#include <boost/graph/strong_components.hpp>
+#include <limits>
+#include <unordered_map>
+#include <vector>
 
 #include "../AuxDataSchema.h"
 
@@ -51,36 +52,122 @@ void SccPass::loadImpl(AnalysisPassResult& Result, const gtirb::Context& Context
 {
 }
 
+// Number the strongly connected components of a graph given in compressed
+// sparse row form: the successors of vertex V are Targets[Offsets[V]] to
+// Targets[Offsets[V + 1] - 1]. This is an iterative version of Tarjan's
+// algorithm; like boost::strong_components, it visits the vertices and edges
+// in order and numbers the components in the order they are completed.
+std::vector<size_t> stronglyConnectedComponents(const std::vector<size_t>& Offsets,
+                                                const std::vector<size_t>& Targets)
+{
+    const size_t VertexCount = Offsets.size() - 1;
+    const size_t None = std::numeric_limits<size_t>::max();
+
+    std::vector<size_t> Index(VertexCount, None);
+    std::vector<size_t> LowLink(VertexCount, 0);
+    std::vector<size_t> Component(VertexCount, None);
+    std::vector<size_t> Stack;
+    // Depth-first search frames: a vertex and the position of its next edge.
+    std::vector<std::pair<size_t, size_t>> Frames;
+    size_t Time = 0;
+    size_t ComponentCount = 0;
+
+    for(size_t Root = 0; Root < VertexCount; Root++)
+    {
+        if(Index[Root] != None)
+        {
+            continue;
+        }
+        Index[Root] = LowLink[Root] = Time++;
+        Stack.push_back(Root);
+        Frames.emplace_back(Root, Offsets[Root]);
+
+        while(!Frames.empty())
+        {
+            const size_t V = Frames.back().first;
+            size_t& Next = Frames.back().second;
+            if(Next < Offsets[V + 1])
+            {
+                const size_t W = Targets[Next++];
+                if(Index[W] == None)
+                {
+                    Index[W] = LowLink[W] = Time++;
+                    Stack.push_back(W);
+                    Frames.emplace_back(W, Offsets[W]);
+                }
+                else if(Component[W] == None)
+                {
+                    LowLink[V] = std::min(LowLink[V], Index[W]);
+                }
+                continue;
+            }
+
+            // All the successors of V have been visited.
+            Frames.pop_back();
+            if(LowLink[V] == Index[V])
+            {
+                size_t W;
+                do
+                {
+                    W = Stack.back();
+                    Stack.pop_back();
+                    Component[W] = ComponentCount;
+                } while(W != V);
+                ComponentCount++;
+            }
+            if(!Frames.empty())
+            {
+                const size_t Parent = Frames.back().first;
+                LowLink[Parent] = std::min(LowLink[Parent], LowLink[V]);
+            }
+        }
+    }
+    return Component;
+}
+
 void SccPass::analyzeImpl(AnalysisPassResult& Result, const gtirb::Module& Module)
 {
     auto& Cfg = Module.getIR()->getCFG();
     KeepIntraProcedural Filter;
-    boost::filtered_graph<gtirb::CFG, KeepIntraProcedural> CfgFiltered(Cfg, Filter);
-
-    typedef std::map<gtirb::CFG::vertex_descriptor, size_t> PropertyMap;
-
-    // Property map to store SCCs
-    PropertyMap SccComponents;
-    boost::associative_property_map<PropertyMap> SccComponentsMap(SccComponents);
 
-    // Create property map with indexes.
-    // This is needed because we use lists for storing vertices.
-    PropertyMap Index;
-    boost::associative_property_map<PropertyMap> IndexMap(Index);
-    size_t I = 0;
+    // Number the vertices once, so that the rest of the computation can use
+    // vectors indexed by vertex number.
+    std::vector<gtirb::CFG::vertex_descriptor> Vertices;
+    std::unordered_map<gtirb::CFG::vertex_descriptor, size_t> VertexIndex;
+    Vertices.reserve(boost::num_vertices(Cfg));
+    VertexIndex.reserve(boost::num_vertices(Cfg));
     for(auto Vertex : boost::make_iterator_range(boost::vertices(Cfg)))
     {
-        boost::put(IndexMap, Vertex, I++);
+        VertexIndex.emplace(Vertex, Vertices.size());
+        Vertices.push_back(Vertex);
+    }
+
+    // Intra-procedural edges in compressed sparse row form.
+    std::vector<size_t> Offsets;
+    std::vector<size_t> Targets;
+    Offsets.reserve(Vertices.size() + 1);
+    Targets.reserve(boost::num_edges(Cfg));
+    Offsets.push_back(0);
+    for(auto Vertex : Vertices)
+    {
+        for(auto Edge : boost::make_iterator_range(boost::out_edges(Vertex, Cfg)))
+        {
+            if(Filter(Edge))
+            {
+                Targets.push_back(VertexIndex[boost::target(Edge, Cfg)]);
+            }
+        }
+        Offsets.push_back(Targets.size());
     }
 
     // Compute the Sccs
-    strong_components(CfgFiltered, SccComponentsMap, vertex_index_map(IndexMap));
+    std::vector<size_t> SccComponents = stronglyConnectedComponents(Offsets, Targets);
 
     // Store them in AuxData
-    for(auto Vertex : boost::make_iterator_range(vertices(Cfg)))
+    for(size_t I = 0; I < Vertices.size(); I++)
     {
-        gtirb::Node* N = Cfg[Vertex];
-        Sccs[N->getUUID()] = SccComponents[Vertex];
+        gtirb::Node* N = Cfg[Vertices[I]];
+        Sccs[N->getUUID()] = SccComponents[I];
     }
 }
 
@@ -47,6 +47,11 @@ public:
 
     virtual void clear() override;
 
+    virtual bool isOptional() const override
+    {
+        return true;
+    }
+
 protected:
     virtual void loadImpl(AnalysisPassResult& Result, const gtirb::Context& Context,
                           const gtirb::Module& Module,
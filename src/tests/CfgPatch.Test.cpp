@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+
+#include <boost/graph/adjacency_list.hpp>
+#include <gtirb/gtirb.hpp>
+
+#include "../passes/CfgPatch.h"
+
+TEST(Unit_CfgPatch, remove_and_add_edges)
+{
+    gtirb::Context Ctx;
+    gtirb::IR* IR = gtirb::IR::Create(Ctx);
+    gtirb::Module* M = IR->addModule(Ctx, "test");
+    gtirb::Section* S = M->addSection(Ctx, "");
+    gtirb::ByteInterval* I = S->addByteInterval(Ctx, gtirb::Addr(0), 4);
+
+    gtirb::CodeBlock* B1 = I->addBlock<gtirb::CodeBlock>(Ctx, 0, 1);
+    gtirb::CodeBlock* B2 = I->addBlock<gtirb::CodeBlock>(Ctx, 1, 1);
+    gtirb::CodeBlock* B3 = I->addBlock<gtirb::CodeBlock>(Ctx, 2, 1);
+
+    gtirb::EdgeLabel SimpleFallthrough = std::make_tuple(
+        gtirb::ConditionalEdge::OnFalse, gtirb::DirectEdge::IsDirect, gtirb::EdgeType::Fallthrough);
+    gtirb::EdgeLabel SimpleCall = std::make_tuple(
+        gtirb::ConditionalEdge::OnFalse, gtirb::DirectEdge::IsDirect, gtirb::EdgeType::Call);
+
+    gtirb::CFG& Cfg = M->getIR()->getCFG();
+    Cfg[*addEdge(B1, B2, Cfg)] = SimpleFallthrough;
+    Cfg[*addEdge(B1, B3, Cfg)] = SimpleCall;
+    Cfg[*addEdge(B2, B3, Cfg)] = SimpleFallthrough;
+
+    CfgPatch Patch;
+    EXPECT_TRUE(Patch.empty());
+    Patch.removeOutEdges(B1, gtirb::EdgeType::Fallthrough);
+    Patch.addEdge(B3, B1, SimpleCall);
+    EXPECT_FALSE(Patch.empty());
+    Patch.apply(Cfg);
+
+    // Only the fallthrough edge of B1 is removed.
+    EXPECT_EQ(boost::out_degree(*gtirb::getVertex(B1, Cfg), Cfg), 1U);
+    EXPECT_EQ(boost::out_degree(*gtirb::getVertex(B2, Cfg), Cfg), 1U);
+    EXPECT_EQ(boost::out_degree(*gtirb::getVertex(B3, Cfg), Cfg), 1U);
+    EXPECT_EQ(boost::num_edges(Cfg), 3U);
+}
@@ -6,6 +6,8 @@
 #include "../gtirb-builder/GtirbBuilder.h"
 #include "../gtirb-decoder/CompositeLoader.h"
 #include "../gtirb-decoder/DatalogIO.h"
+#include "../gtirb-decoder/Executor.h"
+#include "../gtirb-decoder/arch/X64Loader.h"
 #include "../gtirb-decoder/core/AuxDataLoader.h"
 
 class CompositeLoaderTest : public ::testing::TestWithParam<const char*>
@@ -40,6 +42,40 @@ void TestLoaderFunction(const gtirb::Module& Module, souffle::SouffleProgram& Pr
     relations::insert(Program, "in_scc", Tuples);
 }
 
+void TestEdgeLoader(const gtirb::Module& Module, souffle::SouffleProgram& Program)
+{
+    if(auto* Relation = Program.getRelation("cfg_edge_to_top"))
+    {
+        souffle::tuple Row(Relation);
+        Row << gtirb::Addr(2) << std::string("false") << std::string("true")
+            << std::string("jump");
+        Relation->insert(Row);
+    }
+}
+
+// Concurrent loader that computes an in_scc tuple ahead of time.
+class TestConcurrentLoader
+{
+public:
+    TestConcurrentLoader(uint64_t I, std::string R = "in_scc") : Index{I}, Relation{R} {};
+    void prepare(const gtirb::Module& Module, souffle::SouffleProgram& Program)
+    {
+    }
+    std::function<void(souffle::SouffleProgram&)> facts(const gtirb::Module& Module)
+    {
+        std::vector<relations::SccIndex> Tuples = {
+            relations::SccIndex{Index, static_cast<int64_t>(Index), gtirb::Addr(Index)}};
+        std::string Name = Relation;
+        return [Tuples, Name](souffle::SouffleProgram& Program) {
+            relations::insert(Program, Name, Tuples);
+        };
+    }
+
+private:
+    uint64_t Index;
+    std::string Relation;
+};
+
 TEST_P(CompositeLoaderTest, build_test_loader)
 {
     // Load GTIRB.
@@ -56,5 +92,116 @@ TEST_P(CompositeLoaderTest, build_test_loader)
     }
 }
 
+TEST_P(CompositeLoaderTest, concurrent_loaders)
+{
+    CompositeLoader Loader = CompositeLoader("souffle_no_return");
+    Loader.addConcurrent(TestConcurrentLoader(0), {"in_scc"});
+    Loader.add(TestEdgeLoader);
+    Loader.addConcurrent(TestConcurrentLoader(1), {"in_scc"});
+    Loader.addConcurrent(TestConcurrentLoader(2), {"in_scc"});
+
+    std::unique_ptr<souffle::SouffleProgram> Sequential = Loader.load(*Module);
+    std::unique_ptr<souffle::SouffleProgram> Concurrent = Loader.load(*Module, Executor(4));
+    ASSERT_TRUE(Sequential);
+    ASSERT_TRUE(Concurrent);
+
+    EXPECT_EQ(Concurrent->getRelation("in_scc")->size(), 3);
+    for(const char* Name : {"in_scc", "cfg_edge_to_top"})
+    {
+        std::stringstream Expected, Actual;
+        DatalogIO::writeRelation(Expected, *Sequential, Sequential->getRelation(Name));
+        DatalogIO::writeRelation(Actual, *Concurrent, Concurrent->getRelation(Name));
+        EXPECT_EQ(Actual.str(), Expected.str());
+    }
+}
+
+TEST_P(CompositeLoaderTest, concurrent_loader_undeclared_relation)
+{
+    CompositeLoader Loader = CompositeLoader("souffle_no_return");
+    Loader.addConcurrent(TestConcurrentLoader(0), {"in_scc"});
+    Loader.addConcurrent(TestConcurrentLoader(1, "in_scc"), {"cfg_edge"});
+
+    EXPECT_DEBUG_DEATH(Loader.load(*Module, Executor(2)), "undeclared relation");
+}
+
+#if defined(DDISASM_X86_64)
+TEST_P(CompositeLoaderTest, prune_superset)
+{
+    CompositeLoader Superset = CompositeLoader("souffle_disasm_x86_64");
+    Superset.add<X64Loader>();
+
+    CompositeLoader Pruned = CompositeLoader("souffle_disasm_x86_64");
+    Pruned.addOption("prune-superset");
+    Pruned.add<X64Loader>();
+
+    std::unique_ptr<souffle::SouffleProgram> SupersetProgram = Superset.load(*Module);
+    std::unique_ptr<souffle::SouffleProgram> PrunedProgram = Pruned.load(*Module);
+    ASSERT_TRUE(SupersetProgram);
+    ASSERT_TRUE(PrunedProgram);
+
+    EXPECT_FALSE(relations::hasOption(*SupersetProgram, "prune-superset"));
+    EXPECT_TRUE(relations::hasOption(*PrunedProgram, "prune-superset"));
+
+    // Function symbols cover most of .text, so fewer offsets are decoded.
+    EXPECT_LT(PrunedProgram->getRelation("instruction")->size(),
+              SupersetProgram->getRelation("instruction")->size());
+}
+
+TEST_P(CompositeLoaderTest, prune_superset_nested_function)
+{
+    auto LoadPruned = [this]() {
+        CompositeLoader Loader = CompositeLoader("souffle_disasm_x86_64");
+        Loader.addOption("prune-superset");
+        Loader.add<X64Loader>();
+        return Loader.load(*Module);
+    };
+    std::unique_ptr<souffle::SouffleProgram> Pruned = LoadPruned();
+    ASSERT_TRUE(Pruned);
+
+    // Find the largest function.
+    auto* SymbolInfo = Module->getAuxData<gtirb::schema::ElfSymbolInfo>();
+    ASSERT_TRUE(SymbolInfo);
+    std::optional<auxdata::ElfSymbolInfo> Outer;
+    uint64_t Begin = 0;
+    for(const auto& Symbol : Module->symbols())
+    {
+        auto Found = SymbolInfo->find(Symbol.getUUID());
+        if(Symbol.getAddress() && Found != SymbolInfo->end()
+           && std::get<1>(Found->second) == "FUNC"
+           && (!Outer || std::get<0>(Found->second) > std::get<0>(*Outer)))
+        {
+            Outer = Found->second;
+            Begin = static_cast<uint64_t>(*Symbol.getAddress());
+        }
+    }
+    ASSERT_TRUE(Outer);
+    uint64_t End = Begin + std::get<0>(*Outer);
+
+    // Nest a function that starts at the second instruction of the sweep and
+    // ends in the middle of the largest function.
+    uint64_t Second = End;
+    for(auto& Row : *Pruned->getRelation("instruction"))
+    {
+        uint64_t Addr;
+        Row >> Addr;
+        if(Addr > Begin && Addr < Second)
+        {
+            Second = Addr;
+        }
+    }
+    ASSERT_LT(Second, End);
+    gtirb::Symbol* Nested = Module->addSymbol(*Context, gtirb::Addr(Second), "nested");
+    auxdata::ElfSymbolInfo NestedInfo = *Outer;
+    std::get<0>(NestedInfo) = (End - Second) / 2;
+    (*SymbolInfo)[Nested->getUUID()] = NestedInfo;
+
+    // The rest of the largest function is still pruned after the nested one.
+    std::unique_ptr<souffle::SouffleProgram> WithNested = LoadPruned();
+    ASSERT_TRUE(WithNested);
+    EXPECT_EQ(WithNested->getRelation("instruction")->size(),
+              Pruned->getRelation("instruction")->size());
+}
+#endif // DDISASM_X86_64
+
 INSTANTIATE_TEST_SUITE_P(GtirbDecoderTests, CompositeLoaderTest,
                          testing::Values("inputs/hello.x64.elf"));
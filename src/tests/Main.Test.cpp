@@ -29,6 +29,8 @@ void registerTestAuxDataTypes()
     gtirb::AuxDataContainer::registerAuxDataType<LibraryPaths>();
     gtirb::AuxDataContainer::registerAuxDataType<SymbolicExpressionSizes>();
     gtirb::AuxDataContainer::registerAuxDataType<DdisasmVersion>();
+    gtirb::AuxDataContainer::registerAuxDataType<AnalysisBudget>();
+    gtirb::AuxDataContainer::registerAuxDataType<DdisasmDegradations>();
     gtirb::AuxDataContainer::registerAuxDataType<ElfStackSize>();
     gtirb::AuxDataContainer::registerAuxDataType<ElfStackExec>();
     gtirb::AuxDataContainer::registerAuxDataType<ElfSoname>();
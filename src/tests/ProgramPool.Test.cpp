@@ -0,0 +1,86 @@
+//===- ProgramPool.Test.cpp -------------------------------------*- C++ -*-===//
+//
+//  Copyright (C) 2024 GrammaTech, Inc.
+//
+//  This code is licensed under the GNU Affero General Public License
+//  as published by the Free Software Foundation, either version 3 of
+//  the License, or (at your option) any later version. See the
+//  LICENSE.txt file in the project root for license terms or visit
+//  https://www.gnu.org/licenses/agpl.txt.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU Affero General Public License for more details.
+//
+//  This project is sponsored by the Office of Naval Research, One Liberty
+//  Center, 875 N. Randolph Street, Arlington, VA 22203 under contract #
+//  N68335-17-C-0700.  The content of the information does not necessarily
+//  reflect the position or policy of the Government and no official
+//  endorsement should be inferred.
+//
+//===----------------------------------------------------------------------===//
+#include <gtest/gtest.h>
+
+#include "../gtirb-decoder/ProgramPool.h"
+#include "../gtirb-decoder/Relations.h"
+
+TEST(ProgramPoolTest, reuse_purged_program)
+{
+    ProgramPool Pool;
+    Pool.setCapacity(1);
+    std::unique_ptr<souffle::SouffleProgram> Program = Pool.acquire("souffle_no_return");
+    ASSERT_TRUE(Program);
+    auto Tuples = {relations::SccIndex{0, 0, gtirb::Addr(0)}};
+    relations::insert(*Program, "in_scc", Tuples);
+    EXPECT_EQ(Program->getRelation("in_scc")->size(), 1);
+
+    souffle::SouffleProgram* Released = Program.get();
+    Pool.release(std::move(Program));
+
+    // The same instance comes back, with no tuples left.
+    std::unique_ptr<souffle::SouffleProgram> Reused = Pool.acquire("souffle_no_return");
+    ASSERT_EQ(Reused.get(), Released);
+    for(souffle::Relation* Relation : Reused->getAllRelations())
+    {
+        EXPECT_EQ(Relation->size(), 0) << Relation->getName();
+    }
+}
+
+TEST(ProgramPoolTest, capacity)
+{
+    ProgramPool Pool;
+    Pool.setCapacity(1);
+    std::unique_ptr<souffle::SouffleProgram> First = Pool.acquire("souffle_no_return");
+    std::unique_ptr<souffle::SouffleProgram> Second = Pool.acquire("souffle_no_return");
+    ASSERT_TRUE(First && Second);
+    EXPECT_NE(First.get(), Second.get());
+
+    souffle::SouffleProgram* Kept = First.get();
+    Pool.release(std::move(First));
+    Pool.release(std::move(Second));
+    First = Pool.acquire("souffle_no_return");
+    Second = Pool.acquire("souffle_no_return");
+    EXPECT_EQ(First.get(), Kept);
+    EXPECT_NE(Second.get(), Kept);
+}
+
+TEST(ProgramPoolTest, no_reuse_by_default)
+{
+    ProgramPool Pool;
+    std::unique_ptr<souffle::SouffleProgram> Program = Pool.acquire("souffle_no_return");
+    ASSERT_TRUE(Program);
+    Program->getSymbolTable().encode("previous_module");
+    Pool.release(std::move(Program));
+
+    // The next program is a new instance, without the symbols of the first.
+    std::unique_ptr<souffle::SouffleProgram> Fresh = Pool.acquire("souffle_no_return");
+    ASSERT_TRUE(Fresh);
+    EXPECT_FALSE(Fresh->getSymbolTable().weakContains("previous_module"));
+}
+
+TEST(ProgramPoolTest, unknown_program)
+{
+    ProgramPool Pool;
+    EXPECT_FALSE(Pool.acquire("no_such_program"));
+}
@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <boost/graph/filtered_graph.hpp>
+#include <boost/graph/strong_components.hpp>
+#include <functional>
 #include <gtirb/gtirb.hpp>
 
 #include "../AnalysisPipeline.h"
@@ -153,3 +156,66 @@ TEST(Unit_SccPass, loops_and_call)
     EXPECT_NE(SccTable->find(B1->getUUID())->second, SccTable->find(B4->getUUID())->second);
     EXPECT_NE(SccTable->find(B2->getUUID())->second, SccTable->find(B4->getUUID())->second);
 }
+
+TEST(Unit_SccPass, same_as_boost_strong_components)
+{
+    gtirb::Context Ctx;
+    gtirb::IR* IR = gtirb::IR::Create(Ctx);
+    gtirb::Module* M = IR->addModule(Ctx, "test");
+    gtirb::Section* S = M->addSection(Ctx, "");
+    const uint64_t BlockCount = 2000;
+    gtirb::ByteInterval* I = S->addByteInterval(Ctx, gtirb::Addr(0), BlockCount);
+
+    std::vector<gtirb::CodeBlock*> Blocks;
+    for(uint64_t Offset = 0; Offset < BlockCount; Offset++)
+    {
+        Blocks.push_back(I->addBlock<gtirb::CodeBlock>(Ctx, Offset, 1));
+    }
+
+    // Pseudo-random edges with a fixed seed, mixing intra- and
+    // inter-procedural edge types.
+    const gtirb::EdgeType Types[] = {gtirb::EdgeType::Branch, gtirb::EdgeType::Fallthrough,
+                                     gtirb::EdgeType::Call, gtirb::EdgeType::Return};
+    gtirb::CFG& Cfg = M->getIR()->getCFG();
+    uint64_t Seed = 12345;
+    auto Random = [&Seed]() {
+        Seed = Seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return Seed >> 33;
+    };
+    for(uint64_t E = 0; E < 3 * BlockCount; E++)
+    {
+        gtirb::CodeBlock* Src = Blocks[Random() % BlockCount];
+        gtirb::CodeBlock* Dest = Blocks[Random() % BlockCount];
+        Cfg[*addEdge(Src, Dest, Cfg)] = std::make_tuple(
+            gtirb::ConditionalEdge::OnFalse, gtirb::DirectEdge::IsDirect, Types[Random() % 4]);
+    }
+
+    // Reference result from boost::strong_components.
+    auto Filter = [&Cfg](const gtirb::CFG::edge_descriptor& E) {
+        const gtirb::EdgeLabel& L = Cfg[E];
+        gtirb::EdgeType Type = std::get<gtirb::EdgeType>(*L);
+        return Type == gtirb::EdgeType::Branch || Type == gtirb::EdgeType::Fallthrough;
+    };
+    boost::filtered_graph<gtirb::CFG, std::function<bool(const gtirb::CFG::edge_descriptor&)>>
+        CfgFiltered(Cfg, Filter);
+    std::map<gtirb::CFG::vertex_descriptor, size_t> Components, Index;
+    size_t N = 0;
+    for(auto Vertex : boost::make_iterator_range(boost::vertices(Cfg)))
+    {
+        Index[Vertex] = N++;
+    }
+    boost::strong_components(CfgFiltered, boost::make_assoc_property_map(Components),
+                             boost::vertex_index_map(boost::make_assoc_property_map(Index)));
+
+    AnalysisPipeline Pipeline;
+    Pipeline.push<SccPass>();
+    Pipeline.run(Ctx, *M);
+
+    auto* SccTable = M->getAuxData<gtirb::schema::Sccs>();
+    ASSERT_NE(SccTable, nullptr);
+    for(auto Vertex : boost::make_iterator_range(boost::vertices(Cfg)))
+    {
+        gtirb::Node* Node = Cfg[Vertex];
+        EXPECT_EQ(SccTable->at(Node->getUUID()), static_cast<int64_t>(Components[Vertex]));
+    }
+}
@@ -78,8 +78,9 @@ class TestExamples(unittest.TestCase):
                 subprocess.run(config["teardown"])
 
     def disassemble_example(self, config):
-        path = Path(config["path"]) / config["name"]
-        binary = config.get("binary", config["name"])
+        example = config.get("example", config["name"])
+        path = Path(config["path"]) / example
+        binary = config.get("binary", example)
         args = {
             "extra_compile_flags": config["build"]["flags"],
             "extra_reassemble_flags": config.get("reassemble", {}).get(
@@ -1,3 +1,4 @@
+import json
 import os
 import platform
 import subprocess
@@ -200,6 +201,92 @@ class ExtraArgsTest(unittest.TestCase):
                     "Slowest relations to fully evaluate", p.stdout.decode()
                 )
 
+    @unittest.skipUnless(
+        platform.system() == "Linux", "This test is linux only."
+    )
+    def test_max_memory(self):
+        """
+        Test that `--max-memory' exits with an error naming the pass
+        """
+        with cd(ex_dir / "ex1"):
+            self.assertTrue(compile("gcc", "g++", "-O0", []))
+            p = subprocess.run(
+                ["ddisasm", "ex", "--ir", "ex.gtirb", "--max-memory", "1M"],
+                capture_output=True,
+                text=True,
+            )
+            self.assertNotEqual(p.returncode, 0)
+            prefix = "ERROR: memory limit exceeded: "
+            lines = [line for line in p.stderr.splitlines() if prefix in line]
+            self.assertEqual(len(lines), 1)
+            report = json.loads(lines[0].split(prefix, 1)[1])
+            self.assertEqual(report["limit_mib"], 1)
+            self.assertIn(report["pass"], ("disassembly", ""))
+
+    @unittest.skipUnless(
+        platform.system() == "Linux", "This test is linux only."
+    )
+    def test_deadline(self):
+        """
+        Test that a past `--deadline' skips the optional passes and records
+        the degradations in the AuxData
+        """
+        with cd(ex_dir / "ex1"):
+            self.assertTrue(compile("gcc", "g++", "-O0", []))
+            subprocess.run(
+                ["ddisasm", "ex", "--ir", "ex.gtirb", "--deadline", "0"],
+                check=True,
+            )
+            module = gtirb.IR.load_protobuf("ex.gtirb").modules[0]
+            degradations = module.aux_data["ddisasmDegradations"].data
+            self.assertIn(
+                "reduced:disassembly:analysis-budget-low", degradations
+            )
+            for slug in (
+                "SCC-analysis",
+                "no-return-analysis",
+                "function-inference",
+            ):
+                self.assertIn(f"skipped:{slug}", degradations)
+            budget = module.aux_data["analysisBudget"].data
+            self.assertEqual(budget["step_limit"], 8)
+
+    @unittest.skipUnless(
+        platform.system() == "Linux", "This test is linux only."
+    )
+    def test_sampled_profiling(self):
+        """
+        Test `--profile' with the synthesized programs of a ddisasm compiled
+        without DDISASM_SOUFFLE_PROFILING
+        """
+        p = subprocess.run(["ddisasm", "--version"], capture_output=True)
+        if "profiling enabled" in p.stdout.decode():
+            self.skipTest("Profiling enabled")
+
+        with tempfile.TemporaryDirectory() as tmpdir, cd(ex_dir / "ex1"):
+            profile_dir_path = Path(tmpdir, "profiles")
+            self.assertTrue(compile("gcc", "g++", "-O0", []))
+            disassemble(
+                Path("ex"),
+                extra_args=["--profile", profile_dir_path],
+            )
+
+            for name in (
+                "disassembly",
+                "no-return-analysis",
+                "function-inference",
+            ):
+                with open(profile_dir_path / f"{name}.sampled.json") as f:
+                    profile = json.load(f)
+                self.assertEqual(profile["pass"], name)
+                self.assertTrue(profile["sampling"])
+                relations = {
+                    r["name"]: r["tuples"] for r in profile["relations"]
+                }
+                self.assertTrue(relations)
+                if name == "disassembly":
+                    self.assertGreater(relations["block"], 0)
+
 
 if __name__ == "__main__":
     unittest.main()
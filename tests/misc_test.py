@@ -335,6 +335,23 @@ class AuxDataTests(unittest.TestCase):
             # compare the relations directories
             subprocess.check_call(["diff", "dbg", "aux"])
 
+    @unittest.skipUnless(
+        platform.system() == "Linux", "This test is linux only."
+    )
+    def test_binary_features(self):
+        """Test the `binary_feature' facts computed by the loader."""
+        for example, has_tls in (("ex1", False), ("ex_thread_local", True)):
+            with self.subTest(example=example), cd(ex_dir / example):
+                self.assertTrue(compile("gcc", "g++", "-O0", []))
+                ir = disassemble(
+                    Path("ex"), extra_args=["-F", "--with-souffle-relations"]
+                ).ir()
+                m = ir.modules[0]
+
+                facts = m.aux_data["souffleFacts"].data
+                _, csv = facts["disassembly.binary_feature"]
+                self.assertEqual("tls" in csv.split(), has_tls)
+
     def assert_regex_match(self, text, pattern):
         """
         Like unittest's assertRegex, but also return the match object on
@@ -429,6 +446,32 @@ class AuxDataTests(unittest.TestCase):
                 # verify executable bit
                 self.assertEqual(m.aux_data["elfStackExec"].data, is_exec)
 
+    @unittest.skipUnless(
+        platform.system() == "Linux", "This test is linux only."
+    )
+    def test_analysis_budget(self):
+        """
+        Test that the analysis bounds are recorded in analysisBudget
+        """
+        cases = (
+            ("low", 8),
+            ("normal", 12),
+            ("high", 16),
+        )
+
+        binary = Path("ex")
+        with cd(ex_dir / "ex1"):
+            self.assertTrue(compile("gcc", "g++", "-O0", []))
+            for level, step_limit in cases:
+                with self.subTest(level=level):
+                    ir = disassemble(
+                        binary, extra_args=["--analysis-budget", level]
+                    ).ir()
+                    m = ir.modules[0]
+
+                    budget = m.aux_data["analysisBudget"].data
+                    self.assertEqual(budget["step_limit"], step_limit)
+
     @unittest.skipUnless(
         platform.system() == "Linux", "This test is linux only."
     )
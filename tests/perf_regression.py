@@ -0,0 +1,238 @@
+"""
+Performance regression harness for the end-to-end examples.
+
+Builds the examples described by the end-to-end `*.yaml` configs, disassembles
+each build with `ddisasm --stats` at several thread counts and records the
+per-pass run times, the peak memory usage and the output sizes.
+
+Run with `--update-baseline` to store the measurements as the baseline, and
+without it to compare against the baseline and flag the regressions above
+`--threshold`:
+
+    python3 tests/perf_regression.py --baseline perf.json --update-baseline
+    python3 tests/perf_regression.py --baseline perf.json --threshold 0.1
+"""
+import argparse
+import json
+import subprocess
+import sys
+from pathlib import Path
+from typing import Dict, List
+
+import yaml
+
+from disassemble_reassemble_check import bcolors, cd, compile, get_target
+from end2end_test import compatible_test
+
+# Run times below this many seconds are too noisy to be compared.
+TIME_NOISE_FLOOR = 0.05
+
+
+def disassemble_with_stats(
+    binary: Path, threads: int, test: dict, repeat: int
+) -> dict:
+    """
+    Disassemble 'binary' with 'threads' threads and return the measurements
+    of the fastest of 'repeat' runs.
+    """
+    ir_path = binary.with_name(binary.name + ".gtirb")
+    asm_path = binary.with_name(binary.name + ".s")
+    stats_path = binary.with_name(binary.name + ".stats.json")
+    flags = test.get("disassemble", {}).get("flags", [])
+
+    best = None
+    with get_target(
+        binary,
+        test["test"].get("strip_exe", "strip-dummy"),
+        test["test"].get("strip", False),
+        test["test"].get("sstrip", False),
+    ) as target_binary:
+        for _ in range(repeat):
+            subprocess.run(
+                ["ddisasm", target_binary, "--ir", ir_path, "--asm", asm_path]
+                + ["--stats", stats_path, "-j", str(threads)]
+                + list(flags),
+                timeout=600,
+                check=True,
+                stdout=subprocess.DEVNULL,
+                stderr=subprocess.DEVNULL,
+            )
+            with open(stats_path) as f:
+                stats = json.load(f)
+            if best is None or stats["stages"]["total"] < best["time/total"]:
+                best = summarize(stats)
+                best["size/ir"] = ir_path.stat().st_size
+                best["size/asm"] = asm_path.stat().st_size
+    return best
+
+
+def summarize(stats: dict) -> Dict[str, float]:
+    """
+    Flatten the output of `ddisasm --stats` into metric name/value pairs;
+    the times of a pass are added up over all the modules.
+    """
+    metrics = {"memory/peak_rss_kb": stats["peak_rss_kb"]}
+    for stage, seconds in stats["stages"].items():
+        metrics[f"time/{stage}"] = seconds
+    for module in stats["modules"]:
+        for p in module["passes"]:
+            for phase in ("load", "analyze", "transform"):
+                key = f"time/{p['name']}/{phase}"
+                metrics[key] = metrics.get(key, 0) + p[phase]
+            key = f"memory/{p['name']}/peak_rss_kb"
+            metrics[key] = max(metrics.get(key, 0), p.get("peak_rss_kb", 0))
+    return metrics
+
+
+def measure_example(
+    test: dict, jobs: List[int], repeat: int
+) -> Dict[str, dict]:
+    """
+    Build the example for each compiler and optimization of its config and
+    measure the disassembly of every build at each thread count.
+    """
+    results = {}
+    example = test.get("example", test["name"])
+    make_dir = Path(test["path"]) / example
+    binary = Path(test.get("binary", example))
+    build = test["build"]
+    with cd(make_dir):
+        for compiler, cxx_compiler in zip(build["c"], build["cpp"]):
+            for optimization in build["optimizations"]:
+                key = "/".join([test["name"], compiler, optimization])
+                print(bcolors.okblue("Measuring", key))
+                if not compile(
+                    compiler,
+                    cxx_compiler,
+                    optimization,
+                    build["flags"],
+                    test["test"].get("wrapper"),
+                    test.get("arch"),
+                ):
+                    print(bcolors.fail("Build failed"))
+                    continue
+                results[key] = {
+                    str(threads): disassemble_with_stats(
+                        binary, threads, test, repeat
+                    )
+                    for threads in jobs
+                }
+    return results
+
+
+def measure(configs: List[Path], jobs: List[int], repeat: int) -> dict:
+    results = {}
+    for path in configs:
+        with open(str(path)) as f:
+            config = yaml.safe_load(f)
+        if not compatible_test(config, {}):
+            continue
+        if "setup" in config:
+            subprocess.run(config["setup"])
+        for test in config["tests"]:
+            if compatible_test(config, test):
+                results.update(measure_example(test, jobs, repeat))
+        if "teardown" in config:
+            subprocess.run(config["teardown"])
+    return results
+
+
+def compare(baseline: dict, current: dict, threshold: float) -> int:
+    """
+    Print the metrics that grew more than 'threshold' (a ratio) over the
+    baseline and return how many there are.
+    """
+    regressions = 0
+    for key, runs in sorted(current.items()):
+        for threads, metrics in runs.items():
+            base = baseline.get(key, {}).get(threads)
+            if base is None:
+                print(bcolors.warning(f"{key} -j{threads}: no baseline"))
+                continue
+            for metric, value in sorted(metrics.items()):
+                old = base.get(metric)
+                if old is None or old <= 0:
+                    continue
+                if metric.startswith("time/") and old < TIME_NOISE_FLOOR:
+                    continue
+                ratio = value / old - 1
+                if ratio > threshold:
+                    regressions += 1
+                    print(
+                        bcolors.fail(
+                            f"{key} -j{threads} {metric}: {old:g} -> "
+                            f"{value:g} (+{ratio:.1%})"
+                        )
+                    )
+    return regressions
+
+
+def print_scaling(current: dict):
+    """
+    Print the speedup of the total run time at each thread count relative
+    to the smallest one.
+    """
+    for key, runs in sorted(current.items()):
+        counts = sorted(runs, key=int)
+        reference = runs[counts[0]]["time/total"]
+        speedups = [
+            f"-j{threads}: {reference / runs[threads]['time/total']:.2f}x"
+            for threads in counts
+        ]
+        print(f"{key}: " + ", ".join(speedups))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(
+        description="Measure ddisasm on the end-to-end examples and compare "
+        "the measurements with a baseline"
+    )
+    parser.add_argument(
+        "configs",
+        nargs="*",
+        help="end-to-end yaml configs (default: tests/*.yaml)",
+    )
+    parser.add_argument("--baseline", required=True, help="baseline JSON file")
+    parser.add_argument(
+        "--update-baseline",
+        action="store_true",
+        help="store the measurements as the new baseline",
+    )
+    parser.add_argument(
+        "--threshold",
+        type=float,
+        default=0.1,
+        help="relative growth that counts as a regression (default: 0.1)",
+    )
+    parser.add_argument(
+        "--jobs",
+        type=lambda s: [int(j) for j in s.split(",")],
+        default=[1, 2, 4, 8],
+        help="comma-separated thread counts (default: 1,2,4,8)",
+    )
+    parser.add_argument(
+        "--repeat",
+        type=int,
+        default=1,
+        help="disassemble each build this many times and keep the fastest",
+    )
+    args = parser.parse_args()
+
+    configs = [Path(c) for c in args.configs] or sorted(
+        Path("./tests/").glob("*.yaml")
+    )
+    current = measure(configs, args.jobs, args.repeat)
+    print_scaling(current)
+
+    if args.update_baseline:
+        with open(args.baseline, "w") as f:
+            json.dump(current, f, indent=2, sort_keys=True)
+        sys.exit(0)
+
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    regressions = compare(baseline, current, args.threshold)
+    if regressions:
+        print(bcolors.fail(f"{regressions} performance regressions"))
+        sys.exit(1)
+    print(bcolors.okgreen("No performance regressions"))
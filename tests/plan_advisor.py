@@ -0,0 +1,462 @@
+"""
+Profile-guided `.plan` recommendations for the Datalog rules of ddisasm.
+
+Reads the Souffle profiles written by `ddisasm --profile` (with
+`--interpreter` or a `DDISASM_SOUFFLE_PROFILING` build) for a corpus of
+binaries, ranks the rules by evaluation time, flags the rules whose joins
+blow up and proposes a `.plan` and the index each join probes for them:
+
+    python3 tests/plan_advisor.py profiles1/ profiles2/ --top 20
+
+The join of a rule blows up when its cost per output tuple is far above
+the median of the rules. The cost is the tuples the rule visits if the
+profiles have the atom frequencies of `--profile-frequency` for every rule,
+and its time otherwise.
+
+Candidate plans can be validated by re-running the corpus with the Souffle
+interpreter on a copy of the Datalog sources where they are applied:
+
+    python3 tests/plan_advisor.py profiles/ --validate ex1 ex2
+"""
+import argparse
+import json
+import re
+import shutil
+import statistics
+import subprocess
+import sys
+import tempfile
+from dataclasses import dataclass, field
+from pathlib import Path
+from typing import Dict, Iterable, List, Optional, Set, Tuple
+
+LOCATION = re.compile(r"([^\s\[\]]+\.dl) \[(\d+):\d+-(\d+):\d+\]")
+ATOM = re.compile(r"^([A-Za-z_][\w.]*)\s*\((.*)\)$", re.S)
+VARIABLE = re.compile(r"(?<![\w\"'])([A-Za-z_]\w*)(?!\s*\()")
+KEYWORDS = {"nil", "count", "sum", "min", "max", "mean", "as"}
+# Constraints that look like atoms but do not read a relation.
+CONSTRAINTS = {"match", "contains"}
+
+
+@dataclass
+class Atom:
+    relation: str
+    args: List[str]
+
+    def variables(self) -> Set[str]:
+        return {
+            v
+            for arg in self.args
+            for v in VARIABLE.findall(arg)
+            if v != "_" and v not in KEYWORDS
+        }
+
+
+@dataclass
+class Rule:
+    relation: str
+    text: str
+    location: str
+    recursive: bool = False
+    time: float = 0
+    tuples: int = 0
+    visits: int = 0
+    # Versions of a recursive rule in the profiles, one per delta atom.
+    versions: Set[int] = field(default_factory=set)
+
+    def body(self) -> Optional[List[Atom]]:
+        """
+        Positive atoms of the body, in the order `.plan' numbers them, or
+        None if the rule cannot be parsed.
+        """
+        _, sep, body = self.text.partition(":-")
+        if not sep or len(split_top_level(body, ";")) > 1:
+            return None
+        atoms = []
+        for literal in split_top_level(body.strip().rstrip("."), ","):
+            match = ATOM.match(literal.strip())
+            if match and match[1] not in CONSTRAINTS:
+                atoms.append(Atom(match[1], split_top_level(match[2], ",")))
+        return atoms
+
+
+def split_top_level(text: str, separator: str) -> List[str]:
+    """
+    Split 'text' at the occurrences of 'separator' outside of brackets and
+    string literals.
+    """
+    parts, depth, quoted, start = [], 0, False, 0
+    for i, c in enumerate(text):
+        if c == '"':
+            quoted = not quoted
+        elif quoted:
+            continue
+        elif c in "([{":
+            depth += 1
+        elif c in ")]}":
+            depth -= 1
+        elif c == separator and depth == 0:
+            parts.append(text[start:i])
+            start = i + 1
+    parts.append(text[start:])
+    return parts
+
+
+def elapsed(entry: dict) -> float:
+    """
+    Seconds spent in a profile entry (Souffle records microseconds).
+    """
+    runtime = entry.get("runtime", {})
+    return (runtime.get("end", 0) - runtime.get("start", 0)) / 1e6
+
+
+def load_profile(path: Path, rules: Dict[str, Rule], sizes: Dict[str, int]):
+    """
+    Accumulate the rules and relation sizes of a Souffle profile.
+    """
+    with open(path) as f:
+        db = json.load(f)
+    db = db.get("root", db)
+    relations = db.get("program", {}).get("relation", {})
+    for name, relation in relations.items():
+        sizes[name] = max(sizes.get(name, 0), relation.get("num-tuples", 0))
+
+        def add(text, entry, recursive):
+            rule = rules.setdefault(
+                text,
+                Rule(name, text, entry.get("source-locator", ""), recursive),
+            )
+            rule.time += elapsed(entry)
+            rule.tuples += entry.get("num-tuples", 0)
+            return rule
+
+        for text, entry in relation.get("non-recursive-rule", {}).items():
+            add(text, entry, False)
+        for iteration in relation.get("iteration", {}).values():
+            recursive_rules = iteration.get("recursive-rule", {})
+            for text, versions in recursive_rules.items():
+                for version, entry in versions.items():
+                    rule = add(text, entry, True)
+                    if version.isdigit():
+                        rule.versions.add(int(version))
+        for text, atoms in relation.get("atom-frequency", {}).items():
+            if text in rules:
+                rules[text].visits += sum(
+                    a.get("num-tuples", 0) for a in atoms.values()
+                )
+
+
+def find_profiles(paths: Iterable[str]) -> List[Path]:
+    profiles = []
+    for path in map(Path, paths):
+        profiles += sorted(path.rglob("*.prof")) if path.is_dir() else [path]
+    return profiles
+
+
+def blowups(rules: List[Rule], factor: float) -> List[Rule]:
+    """
+    Rules whose cost per output tuple is 'factor' times the median of the
+    rules. The cost is in visited tuples if every rule has atom frequencies,
+    and in seconds otherwise, so that all the rules use the same unit.
+    """
+    timed = [r for r in rules if r.time > 0]
+    if not timed:
+        return []
+    use_visits = all(r.visits for r in timed)
+
+    def cost(rule):
+        spent = rule.visits if use_visits else rule.time
+        return spent / max(rule.tuples, 1)
+
+    median = statistics.median(cost(r) for r in timed)
+    return [r for r in timed if cost(r) > factor * median]
+
+
+def dependencies(rules: Iterable[Rule]) -> Dict[str, Set[str]]:
+    """
+    The relations each relation reads in the positive atoms of its rules.
+    """
+    graph: Dict[str, Set[str]] = {}
+    for rule in rules:
+        reads = graph.setdefault(rule.relation, set())
+        reads |= {a.relation for a in rule.body() or []}
+    return graph
+
+
+def reachable(graph: Dict[str, Set[str]], start: str) -> Set[str]:
+    seen, stack = {start}, [start]
+    while stack:
+        for successor in graph.get(stack.pop(), ()):
+            if successor not in seen:
+                seen.add(successor)
+                stack.append(successor)
+    return seen
+
+
+def scc(graph: Dict[str, Set[str]], relation: str) -> Set[str]:
+    """
+    The relations that are mutually recursive with 'relation', i.e. in the
+    same stratum.
+    """
+    reverse: Dict[str, Set[str]] = {}
+    for source, targets in graph.items():
+        for target in targets:
+            reverse.setdefault(target, set()).add(source)
+    return reachable(graph, relation) & reachable(reverse, relation)
+
+
+def greedy_order(
+    body: List[Atom], sizes: Dict[str, int], first: Optional[int] = None
+) -> List[int]:
+    """
+    Join order that starts from 'first' (or the smallest relation) and then
+    picks the atom sharing the most variables with those already bound,
+    preferring the smaller relations.
+    """
+    remaining = list(range(len(body)))
+    order, bound = [], set()
+    while remaining:
+        if first is not None and not order:
+            best = first
+        else:
+            best = min(
+                remaining,
+                key=lambda i: (
+                    -len(body[i].variables() & bound),
+                    sizes.get(body[i].relation, 0),
+                    i,
+                ),
+            )
+        remaining.remove(best)
+        order.append(best)
+        bound |= body[best].variables()
+    return order
+
+
+def probed_columns(body: List[Atom], order: List[int]) -> List[str]:
+    """
+    The columns each atom is looked up by in the given order, which is the
+    index Souffle needs for the join to be efficient.
+    """
+    hints, bound = [], set()
+    for i in order:
+        atom = body[i]
+        columns = [
+            str(c)
+            for c, arg in enumerate(atom.args)
+            if set(VARIABLE.findall(arg)) & bound or not VARIABLE.findall(arg)
+        ]
+        if bound and columns:
+            hints.append(f"{atom.relation}({','.join(columns)})")
+        bound |= atom.variables()
+    return hints
+
+
+def recommend(
+    rule: Rule, sizes: Dict[str, int], graph: Dict[str, Set[str]]
+) -> Optional[Tuple[str, List[str]]]:
+    """
+    The `.plan' directive and index hints for 'rule', or None if the
+    default order is already the recommended one.
+    """
+    body = rule.body()
+    if not body or len(body) < 2:
+        return None
+    plans, hints = [], []
+    if rule.recursive:
+        # Version N of a recursive rule reads the delta of its N-th atom
+        # from the stratum of the head, which should come first.
+        stratum = scc(graph, rule.relation)
+        deltas = [i for i, a in enumerate(body) if a.relation in stratum]
+        if not rule.versions <= set(range(len(deltas))):
+            # The profiles disagree with the parsed rule.
+            return None
+        for version, delta in enumerate(deltas):
+            order = greedy_order(body, sizes, delta)
+            hints += probed_columns(body, order)
+            if order != list(range(len(body))):
+                plans.append((version, order))
+    else:
+        order = greedy_order(body, sizes)
+        hints += probed_columns(body, order)
+        if order != list(range(len(body))):
+            plans.append((0, order))
+    if not plans:
+        return None
+    directive = ".plan " + ", ".join(
+        f"{v}: ({','.join(str(i + 1) for i in order)})" for v, order in plans
+    )
+    return directive, sorted(set(hints))
+
+
+def find_source(location: str, datalog_dirs: List[Path]):
+    match = LOCATION.search(location)
+    if not match:
+        return None
+    name = Path(match[1]).name
+    for directory in datalog_dirs:
+        for path in directory.rglob(name):
+            return path, int(match[3])
+    return None
+
+
+def apply_plans(
+    recommendations: List[Tuple[Rule, str]], datalog_dirs: List[Path]
+) -> Dict[Path, List[str]]:
+    """
+    Insert the `.plan' directives after their rules, replacing the existing
+    ones, and return the modified sources by path.
+    """
+    edits: Dict[Path, List[Tuple[int, str]]] = {}
+    for rule, directive in recommendations:
+        source = find_source(rule.location, datalog_dirs)
+        if source:
+            edits.setdefault(source[0], []).append((source[1], directive))
+    sources = {}
+    for path, inserts in edits.items():
+        lines = path.read_text().splitlines()
+        for line, directive in sorted(inserts, reverse=True):
+            # The existing plan of the rule may follow a comment.
+            plan = line
+            while plan < len(lines) and (
+                not lines[plan].strip() or lines[plan].strip().startswith("//")
+            ):
+                plan += 1
+            if plan < len(lines) and lines[plan].strip().startswith(".plan"):
+                indent = re.match(r"\s*", lines[plan])[0]
+                lines[plan] = indent + directive
+            else:
+                indent = re.match(r"\s*", lines[line - 1])[0]
+                lines.insert(line, indent + directive)
+        sources[path] = lines
+    return sources
+
+
+def run_corpus(binaries: List[str], root: Path, ddisasm_args: List[str]):
+    """
+    Seconds spent in the analyses of each binary with the interpreter on
+    the Datalog sources under 'root'.
+    """
+    times = []
+    for binary in binaries:
+        with tempfile.TemporaryDirectory() as tmp:
+            stats = Path(tmp) / "stats.json"
+            subprocess.run(
+                ["ddisasm", binary, "--ir", str(Path(tmp) / "out.gtirb")]
+                + ["--interpreter", str(root), "--debug-dir", tmp]
+                + ["--stats", str(stats)]
+                + ddisasm_args,
+                check=True,
+                stdout=subprocess.DEVNULL,
+                stderr=subprocess.DEVNULL,
+            )
+            with open(stats) as f:
+                times.append(json.load(f)["stages"]["analysis"])
+    return times
+
+
+def validate(
+    sources: Dict[Path, List[str]],
+    repo: Path,
+    binaries: List[str],
+    ddisasm_args: List[str],
+) -> bool:
+    """
+    Re-run the corpus with the interpreter with and without the plans and
+    report whether the analyses got faster.
+    """
+    baseline = run_corpus(binaries, repo, ddisasm_args)
+    with tempfile.TemporaryDirectory() as tmp:
+        root = Path(tmp)
+        for directory in ("src/datalog", "src/passes/datalog"):
+            shutil.copytree(repo / directory, root / directory)
+        for path, lines in sources.items():
+            relative = path.resolve().relative_to(repo.resolve())
+            (root / relative).write_text("\n".join(lines) + "\n")
+        candidate = run_corpus(binaries, root, ddisasm_args)
+    for binary, old, new in zip(binaries, baseline, candidate):
+        print(f"{binary}: {old:.2f}s -> {new:.2f}s ({old / new:.2f}x)")
+    return sum(candidate) < sum(baseline)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Recommend .plan directives from Souffle profiles"
+    )
+    parser.add_argument("profiles", nargs="+", help="profile files or dirs")
+    parser.add_argument(
+        "--top", type=int, default=20, help="number of rules to rank"
+    )
+    parser.add_argument(
+        "--blowup",
+        type=float,
+        default=10,
+        help="cost over the median cost that flags a join (default: 10)",
+    )
+    parser.add_argument(
+        "--repo",
+        type=Path,
+        default=Path(__file__).resolve().parent.parent,
+        help="ddisasm source tree with the Datalog rules",
+    )
+    parser.add_argument(
+        "--write", action="store_true", help="apply the plans to the sources"
+    )
+    parser.add_argument(
+        "--validate",
+        nargs="+",
+        metavar="BINARY",
+        help="re-run these binaries with and without the plans",
+    )
+    parser.add_argument(
+        "--ddisasm-args",
+        type=str.split,
+        default=[],
+        help="extra ddisasm arguments for --validate, e.g. '-j 8 -L lib'",
+    )
+    args = parser.parse_args()
+
+    rules: Dict[str, Rule] = {}
+    sizes: Dict[str, int] = {}
+    profiles = find_profiles(args.profiles)
+    for path in profiles:
+        load_profile(path, rules, sizes)
+    if not rules:
+        sys.exit("error: no rules found in the profiles")
+    graph = dependencies(rules.values())
+
+    ranked = sorted(rules.values(), key=lambda r: r.time, reverse=True)
+    total = sum(r.time for r in ranked)
+    print(f"# {len(rules)} rules in {len(profiles)} profiles, {total:.2f}s")
+    print("# Slowest rules")
+    for rule in ranked[: args.top]:
+        print(
+            f"{rule.time:10.2f}s {rule.time / total:6.1%} "
+            f"{rule.tuples:>12} {rule.relation} {rule.location}"
+        )
+
+    print("# Joins that blow up")
+    recommendations = []
+    for rule in blowups(ranked[: args.top], args.blowup):
+        print(f"{rule.relation} {rule.location}")
+        print("    " + " ".join(rule.text.split()))
+        recommendation = recommend(rule, sizes, graph)
+        if recommendation:
+            directive, hints = recommendation
+            print(f"    candidate: {directive}")
+            print(f"    indexes: {' '.join(hints)}")
+            recommendations.append((rule, directive))
+
+    datalog_dirs = [args.repo / "src" / "datalog", args.repo / "src/passes"]
+    sources = apply_plans(recommendations, datalog_dirs)
+    if args.write:
+        for path, lines in sources.items():
+            path.write_text("\n".join(lines) + "\n")
+    if args.validate:
+        if not validate(sources, args.repo, args.validate, args.ddisasm_args):
+            print("The candidate plans do not speed up the corpus")
+            sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
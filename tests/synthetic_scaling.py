@@ -0,0 +1,270 @@
+"""
+Synthetic large-binary generator for scaling experiments.
+
+Generates C++ programs with a parameterized number of functions, each with
+a dense switch (compiled into a jump table), a function-pointer array over
+all the functions, a string table, thread-local variables and functions
+that throw and catch exceptions. The programs are built with the local
+toolchain and disassembled with `ddisasm --stats` over a sweep of sizes to
+produce the scaling curves of the time and memory of each pass:
+
+    python3 tests/synthetic_scaling.py --sizes 1000,10000,100000 \\
+        --output scaling.json
+
+Use `--generate-only DIR` to only write the sources of the first size.
+"""
+import argparse
+import json
+import os
+import shlex
+import subprocess
+import sys
+import tempfile
+from concurrent.futures import ThreadPoolExecutor
+from dataclasses import dataclass
+from pathlib import Path
+from typing import List
+
+from perf_regression import summarize
+
+
+@dataclass
+class ProgramShape:
+    functions: int
+    switch_cases: int = 16
+    strings: int = 64
+    tls_vars: int = 8
+    throw_every: int = 64
+    units: int = 16
+
+
+def function_source(i: int, shape: ProgramShape) -> str:
+    """
+    Source of the function 'f_{i}'.
+    """
+    cases = "".join(
+        f"    case {c}: r = r * {c + 3} + {(i + c) % 251}; break;\n"
+        for c in range(shape.switch_cases)
+    )
+    tls = ""
+    if shape.tls_vars:
+        tls = f"    tls_{i % shape.tls_vars} += r;\n"
+    throw = ""
+    if shape.throw_every and i % shape.throw_every == 0:
+        throw = f"    if(x == {i}) throw SyntheticError{{{i}}};\n"
+    return (
+        f"int f_{i}(int x)\n{{\n"
+        f"    int r = x ^ {i};\n"
+        f"    switch((x + {i}) % {shape.switch_cases + 1})\n    {{\n"
+        f"{cases}"
+        f"    default: r += strings[{i % shape.strings}][0]; break;\n"
+        f"    }}\n"
+        f"{tls}{throw}"
+        f"    return r;\n}}\n"
+    )
+
+
+def common_header(shape: ProgramShape) -> str:
+    tls = "".join(
+        f"extern thread_local int tls_{t};\n" for t in range(shape.tls_vars)
+    )
+    return (
+        "struct SyntheticError\n{\n    int Value;\n};\n"
+        f"extern const char* const strings[{shape.strings}];\n{tls}"
+    )
+
+
+def main_source(shape: ProgramShape) -> str:
+    decls = "".join(f"int f_{i}(int);\n" for i in range(shape.functions))
+    pointers = ",\n".join(f"    f_{i}" for i in range(shape.functions))
+    strings = ",\n".join(
+        f'    "synthetic string {s}"' for s in range(shape.strings)
+    )
+    tls = "".join(
+        f"thread_local int tls_{t} = {t};\n" for t in range(shape.tls_vars)
+    )
+    return (
+        '#include <cstdio>\n#include "synthetic.h"\n'
+        f"const char* const strings[{shape.strings}] = {{\n{strings}\n}};\n"
+        f"{tls}{decls}"
+        f"int (*const functions[])(int) = {{\n{pointers}\n}};\n"
+        "int main(int argc, char** argv)\n{\n"
+        "    unsigned sum = 0;\n"
+        "    for(auto f : functions)\n    {\n"
+        "        try\n        {\n"
+        "            sum += f(argc);\n"
+        "        }\n"
+        "        catch(const SyntheticError& e)\n        {\n"
+        "            sum += e.Value;\n"
+        "        }\n"
+        "    }\n"
+        '    std::printf("%u\\n", sum);\n'
+        "    return 0;\n}\n"
+    )
+
+
+def generate(shape: ProgramShape, directory: Path) -> List[Path]:
+    """
+    Write the sources of a program with the given shape to 'directory',
+    split in 'shape.units' translation units, and return their paths.
+    """
+    directory.mkdir(parents=True, exist_ok=True)
+    (directory / "synthetic.h").write_text(common_header(shape))
+    sources = [directory / "main.cpp"]
+    sources[0].write_text(main_source(shape))
+    per_unit = -(-shape.functions // shape.units)
+    for unit in range(shape.units):
+        first = unit * per_unit
+        last = min(first + per_unit, shape.functions)
+        if first >= last:
+            break
+        path = directory / f"unit_{unit}.cpp"
+        with open(path, "w") as f:
+            f.write('#include "synthetic.h"\n')
+            for i in range(first, last):
+                f.write(function_source(i, shape))
+        sources.append(path)
+    return sources
+
+
+def build(sources: List[Path], binary: Path, compiler: str, flags: List[str]):
+    """
+    Compile the sources in parallel and link them into 'binary'.
+    """
+
+    def compile_unit(source: Path) -> Path:
+        obj = source.with_suffix(".o")
+        subprocess.run(
+            [compiler, "-c", str(source), "-o", str(obj)] + flags, check=True
+        )
+        return obj
+
+    with ThreadPoolExecutor(os.cpu_count()) as pool:
+        objects = list(pool.map(compile_unit, sources))
+    subprocess.run(
+        [compiler, "-o", str(binary)] + [str(o) for o in objects] + flags,
+        check=True,
+    )
+
+
+def disassemble(binary: Path, threads: int) -> dict:
+    stats_path = binary.with_suffix(".stats.json")
+    ir_path = binary.with_suffix(".gtirb")
+    subprocess.run(
+        ["ddisasm", str(binary), "--ir", str(ir_path)]
+        + ["--stats", str(stats_path), "-j", str(threads)],
+        check=True,
+        stdout=subprocess.DEVNULL,
+        stderr=subprocess.DEVNULL,
+    )
+    with open(stats_path) as f:
+        metrics = summarize(json.load(f))
+    metrics["size/binary"] = binary.stat().st_size
+    metrics["size/ir"] = ir_path.stat().st_size
+    return metrics
+
+
+def sweep(args) -> List[dict]:
+    results = []
+    for size in args.sizes:
+        shape = ProgramShape(
+            functions=size,
+            switch_cases=args.switch_cases,
+            strings=args.strings,
+            tls_vars=args.tls_vars,
+            throw_every=args.throw_every,
+            units=args.units,
+        )
+        with tempfile.TemporaryDirectory() as directory:
+            binary = Path(directory) / "synthetic"
+            print(f"# Building {size} functions", file=sys.stderr)
+            build(
+                generate(shape, Path(directory)),
+                binary,
+                args.compiler,
+                args.flags,
+            )
+            for threads in args.jobs:
+                print(f"# Disassembling with -j{threads}", file=sys.stderr)
+                results.append(
+                    {
+                        "functions": size,
+                        "threads": threads,
+                        "metrics": disassemble(binary, threads),
+                    }
+                )
+    return results
+
+
+def print_curves(results: List[dict]):
+    print("functions threads binary_bytes total_s peak_rss_kb")
+    for r in results:
+        m = r["metrics"]
+        print(
+            r["functions"],
+            r["threads"],
+            m["size/binary"],
+            f"{m['time/total']:.2f}",
+            m["memory/peak_rss_kb"],
+        )
+
+
+if __name__ == "__main__":
+    int_list = lambda s: [int(v) for v in s.split(",")]  # noqa: E731
+    parser = argparse.ArgumentParser(
+        description="Generate synthetic binaries of increasing size and "
+        "measure ddisasm on them"
+    )
+    parser.add_argument(
+        "--sizes",
+        type=int_list,
+        default=[1000, 10000, 100000],
+        help="comma-separated numbers of functions",
+    )
+    parser.add_argument("--switch-cases", type=int, default=16)
+    parser.add_argument("--strings", type=int, default=64)
+    parser.add_argument("--tls-vars", type=int, default=8)
+    parser.add_argument(
+        "--throw-every",
+        type=int,
+        default=64,
+        help="make every n-th function throw an exception (0: none)",
+    )
+    parser.add_argument(
+        "--units", type=int, default=16, help="number of translation units"
+    )
+    parser.add_argument("--compiler", default="g++")
+    parser.add_argument(
+        "--flags",
+        type=shlex.split,
+        default=["-O1"],
+        help="compiler flags, e.g. --flags='-O2 -fPIE'",
+    )
+    parser.add_argument("--jobs", type=int_list, default=[1])
+    parser.add_argument("--output", help="write the measurements as JSON")
+    parser.add_argument(
+        "--generate-only",
+        metavar="DIR",
+        help="write the sources of the first size to DIR and exit",
+    )
+    args = parser.parse_args()
+
+    if args.generate_only:
+        generate(
+            ProgramShape(
+                functions=args.sizes[0],
+                switch_cases=args.switch_cases,
+                strings=args.strings,
+                tls_vars=args.tls_vars,
+                throw_every=args.throw_every,
+                units=args.units,
+            ),
+            Path(args.generate_only),
+        )
+        sys.exit(0)
+
+    results = sweep(args)
+    print_curves(results)
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(results, f, indent=2)